@@ -1,6 +1,10 @@
 #include <Matrix.hpp>
 #include <benchmark/benchmark.h>
 
+#include <filesystem>
+#include <limits>
+#include <thread>
+
 static void BM_abs(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     Matrix sliced_mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
@@ -108,6 +112,126 @@ static void BM_argmin_column(benchmark::State &state) {
 }
 BENCHMARK(BM_argmin_column);
 
+static void BM_batch_inverse(benchmark::State &state) {
+    int count = state.range(0), n = 4;
+    std::vector<double> tensor(count * n * n);
+    for (int k = 0; k < count * n * n; k++)
+        tensor[k] = std::sin(k * 0.37) + ((k % (n * n)) % (n + 1) == 0 ? n : 0);
+    MatrixBatch batch = matrix.batch(tensor, count, n, n);
+    for (auto _ : state)
+        matrix.inverse(batch);
+}
+BENCHMARK(BM_batch_inverse)->RangeMultiplier(8)->Range(64, 32768);
+
+static void BM_batch_inverse_loop(benchmark::State &state) {
+    int count = state.range(0), n = 4;
+    std::vector<Matrix> mats;
+    for (int b = 0; b < count; b++) {
+        std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                vec[i][j] = std::sin(((b * n + i) * n + j) * 0.37) + (i == j ? n : 0);
+        mats.push_back(matrix.init(vec));
+    }
+    for (auto _ : state)
+        for (Matrix &mat : mats)
+            matrix.inverse(mat);
+}
+BENCHMARK(BM_batch_inverse_loop)->RangeMultiplier(8)->Range(64, 32768);
+
+static void BM_batch_determinant(benchmark::State &state) {
+    int count = state.range(0), n = 4;
+    std::vector<double> tensor(count * n * n);
+    for (int k = 0; k < count * n * n; k++)
+        tensor[k] = std::sin(k * 0.37) + ((k % (n * n)) % (n + 1) == 0 ? n : 0);
+    MatrixBatch batch = matrix.batch(tensor, count, n, n);
+    for (auto _ : state)
+        matrix.determinant(batch);
+}
+BENCHMARK(BM_batch_determinant)->RangeMultiplier(8)->Range(64, 32768);
+
+static void BM_block(benchmark::State &state) {
+    int n = state.range(0);
+    Matrix A = matrix.ones(n, n), B = matrix.zeros(n, n), C = matrix.eye(n);
+    for (auto _ : state)
+        matrix.block({{A, B}, {B, C}});
+}
+BENCHMARK(BM_block)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_block_concatenate(benchmark::State &state) {
+    int n = state.range(0);
+    Matrix A = matrix.ones(n, n), B = matrix.zeros(n, n), C = matrix.eye(n);
+    for (auto _ : state)
+        matrix.concatenate(matrix.concatenate(A, B, "column"), matrix.concatenate(B, C, "column"),
+                           "row");
+}
+BENCHMARK(BM_block_concatenate)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_kron(benchmark::State &state) {
+    int n = state.range(0);
+    Matrix A = matrix.eye(4), B = matrix.ones(n, n);
+    for (auto _ : state)
+        matrix.kron(A, B);
+}
+BENCHMARK(BM_kron)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_outer(benchmark::State &state) {
+    int n = state.range(0);
+    Matrix u = matrix.ones(n, 1), v = matrix.ones(1, n);
+    for (auto _ : state)
+        matrix.outer(u, v);
+}
+BENCHMARK(BM_outer)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_cg(benchmark::State &state) {
+    int g = state.range(0), n = g * g;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    for (int i = 0; i < g; i++) {
+        for (int j = 0; j < g; j++) {
+            int k = i * g + j;
+            vec[k][k] = 4;
+            if (i > 0)
+                vec[k][k - g] = vec[k - g][k] = -1;
+            if (j > 0)
+                vec[k][k - 1] = vec[k - 1][k] = -1;
+        }
+    }
+    Matrix A = matrix.init(vec);
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.cg(A, b, 1e-8, 10000, "ichol");
+}
+BENCHMARK(BM_cg)->RangeMultiplier(2)->Range(8, 32);
+
+static void BM_cg_operator(benchmark::State &state) {
+    int g = state.range(0), n = g * g;
+    LinearOperator laplacian = [g](const double *x, double *y) {
+        for (int i = 0; i < g; i++) {
+            for (int j = 0; j < g; j++) {
+                int k = i * g + j;
+                y[k] = 4 * x[k] - ((i > 0) ? x[k - g] : 0) - ((i < g - 1) ? x[k + g] : 0) -
+                       ((j > 0) ? x[k - 1] : 0) - ((j < g - 1) ? x[k + 1] : 0);
+            }
+        }
+    };
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.cg(laplacian, b, 1e-8, 10000);
+}
+BENCHMARK(BM_cg_operator)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_cholesky(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.cholesky(A);
+}
+BENCHMARK(BM_cholesky)->RangeMultiplier(4)->Range(16, 1024);
+
 static void BM_concatenate_column(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     Matrix matc0_3 = mat.slice(1, 10, 0, 3);
@@ -126,6 +250,165 @@ static void BM_concatenate_row(benchmark::State &state) {
 }
 BENCHMARK(BM_concatenate_row);
 
+static void BM_diagonal_matmul(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    DiagonalMatrix D = matrix.diag(matrix.init(vec));
+    Matrix B = matrix.ones(n, n);
+    for (auto _ : state)
+        matrix.matmul(D, B);
+}
+BENCHMARK(BM_diagonal_matmul)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_triangular_solve(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    TriangularMatrix T = matrix.tril(matrix.init(vec));
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.solve(T, b);
+}
+BENCHMARK(BM_triangular_solve)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_symmetric_solve(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    SymmetricMatrix S = matrix.symmetric(matrix.init(vec));
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.solve(S, b);
+}
+BENCHMARK(BM_symmetric_solve)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_eigh(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            vec[i][j] = vec[j][i] = std::sin(i * 0.37 + j * 1.3);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.eigh(A);
+}
+BENCHMARK(BM_eigh)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_eigh_top_k(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            vec[i][j] = vec[j][i] = std::sin(i * 0.37 + j * 1.3);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.eigh(A, 10);
+}
+BENCHMARK(BM_eigh_top_k)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_eigsh(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            vec[i][j] = vec[j][i] = std::sin(i * 0.37 + j * 1.3);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.eigsh(A, 10);
+}
+BENCHMARK(BM_eigsh)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_lstsq(benchmark::State &state) {
+    Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
+    Matrix X = mat.slice(1, mat.row_length(), 0, mat.col_length() - 1);
+    Matrix y = mat.slice(1, mat.row_length(), mat.col_length() - 1, mat.col_length());
+    X.to_double();
+    y.to_double();
+    for (auto _ : state)
+        matrix.lstsq(X, y);
+}
+BENCHMARK(BM_lstsq);
+
+static void BM_lstsq_tall(benchmark::State &state) {
+    int m = state.range(0), n = 20;
+    std::vector<std::vector<double>> x(m, std::vector<double>(n)), y(m, std::vector<double>(1));
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++)
+            x[i][j] = std::cos(i * (j + 0.5));
+        y[i][0] = std::sin(i);
+    }
+    Matrix X = matrix.init(x), Y = matrix.init(y);
+    for (auto _ : state)
+        matrix.lstsq(X, Y);
+}
+BENCHMARK(BM_lstsq_tall)->RangeMultiplier(10)->Range(1000, 100000);
+
+static void BM_lu_threads(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+    int threads = matrix.get_num_threads();
+    matrix.set_num_threads(state.range(1));
+    for (auto _ : state)
+        matrix.lu(A);
+    matrix.set_num_threads(threads);
+    double flops = 2.0 / 3 * n * n * n * state.iterations();
+    state.counters["GFlops"] = benchmark::Counter(flops / 1e9, benchmark::Counter::kIsRate);
+}
+
+// Powers of two threads up to all cores
+BENCHMARK(BM_lu_threads)
+    ->RangeMultiplier(2)
+    ->Ranges({{1024, 4096}, {1, std::max(1u, std::thread::hardware_concurrency())}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+static void BM_multi_dot(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> a(n, std::vector<double>(10)), b(10, std::vector<double>(n)),
+        c(n, std::vector<double>(5));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 10; j++) {
+            a[i][j] = i + j;
+            b[j][i] = i - j;
+        }
+        for (int j = 0; j < 5; j++)
+            c[i][j] = i * j;
+    }
+    Matrix A = matrix.init(a), B = matrix.init(b), C = matrix.init(c);
+    for (auto _ : state)
+        matrix.multi_dot({A, B, C});
+}
+BENCHMARK(BM_multi_dot)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_multi_dot_nested(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> a(n, std::vector<double>(10)), b(10, std::vector<double>(n)),
+        c(n, std::vector<double>(5));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 10; j++) {
+            a[i][j] = i + j;
+            b[j][i] = i - j;
+        }
+        for (int j = 0; j < 5; j++)
+            c[i][j] = i * j;
+    }
+    Matrix A = matrix.init(a), B = matrix.init(b), C = matrix.init(c);
+    for (auto _ : state)
+        matrix.matmul(matrix.matmul(A, B), C);
+}
+BENCHMARK(BM_multi_dot_nested)->RangeMultiplier(4)->Range(16, 1024);
+
 static void BM_pre_decrement(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     Matrix sliced_mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
@@ -245,9 +528,234 @@ BENCHMARK(BM_eye);
 static void BM_genfromtxt(benchmark::State &state) {
     for (auto _ : state)
         matrix.genfromtxt("./datasets/boston/boston.csv", ',');
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/boston/boston.csv"));
 }
 BENCHMARK(BM_genfromtxt);
 
+static void BM_genfromtxt_to_double(benchmark::State &state) {
+    for (auto _ : state) {
+        Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
+        mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
+        mat.to_double();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/boston/boston.csv"));
+}
+BENCHMARK(BM_genfromtxt_to_double);
+
+static void BM_genfromtxt_numeric(benchmark::State &state) {
+    for (auto _ : state)
+        matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1);
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/boston/boston.csv"));
+}
+BENCHMARK(BM_genfromtxt_numeric);
+
+static void BM_genfromtxt_table(benchmark::State &state) {
+    CsvOptions options;
+    options.names = true;
+    for (auto _ : state)
+        matrix.genfromtxt("./datasets/wine/wine.csv", options);
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/wine/wine.csv"));
+}
+BENCHMARK(BM_genfromtxt_table);
+
+static void BM_genfromtxt_table_legacy(benchmark::State &state) {
+    // Load as strings, slice the header and the label column away, then convert
+    for (auto _ : state) {
+        Matrix mat = matrix.genfromtxt("./datasets/wine/wine.csv", ',');
+        mat = mat.slice(1, mat.row_length(), 0, mat.col_length() - 1);
+        mat.to_double();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/wine/wine.csv"));
+}
+BENCHMARK(BM_genfromtxt_table_legacy);
+
+static void BM_load(benchmark::State &state) {
+    // Opening a binary file of state.range(0) rows of 100 columns, without reading the values
+    std::string path = (std::filesystem::temp_directory_path() / "BM_load.bin").string();
+    matrix.save(matrix.zeros(state.range(0), 100), path);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(matrix.load(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_load)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_load_boston(benchmark::State &state) {
+    // Opening boston.csv saved as binary and reading every value, against BM_genfromtxt_numeric
+    std::string path = (std::filesystem::temp_directory_path() / "BM_load_boston.bin").string();
+    matrix.save(matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1), path);
+    for (auto _ : state) {
+        MatrixView view = matrix.load(path);
+        benchmark::DoNotOptimize(view.verify());
+    }
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_load_boston);
+
+static void BM_load_npy(benchmark::State &state) {
+    // Opening boston.csv saved as .npy and reading every value
+    std::string path = (std::filesystem::temp_directory_path() / "BM_load_boston.npy").string();
+    matrix.save_npy(matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1), path);
+    for (auto _ : state) {
+        MatrixView view = matrix.load_npy(path);
+        double sum = 0;
+        for (size_t k = 0; k < static_cast<size_t>(view.rows) * view.cols; k++)
+            sum += view.data[k];
+        benchmark::DoNotOptimize(sum);
+    }
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_load_npy);
+
+static void BM_genfromtxt_numeric_large(benchmark::State &state) {
+    // About 16 MB of random values with full precision
+    std::string path = (std::filesystem::temp_directory_path() / "BM_genfromtxt.csv").string();
+    {
+        std::ofstream file(path);
+        file.precision(17);
+        for (int i = 0; i < 40000; i++)
+            for (int j = 0; j < 20; j++)
+                file << std::sin(i * 20.0 + j) * 1000 << ((j == 19) ? '\n' : ',');
+    }
+    for (auto _ : state)
+        matrix.genfromtxt(path, ',', 0);
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_genfromtxt_numeric_large)->Unit(benchmark::kMillisecond);
+
+static void BM_savetxt(benchmark::State &state) {
+    // The 16 MB of BM_genfromtxt_numeric_large written back with full precision
+    std::string path = (std::filesystem::temp_directory_path() / "BM_savetxt.csv").string();
+    std::vector<std::vector<double>> values(40000, std::vector<double>(20));
+    for (int i = 0; i < 40000; i++)
+        for (int j = 0; j < 20; j++)
+            values[i][j] = std::sin(i * 20.0 + j) * 1000;
+    Matrix mat = matrix.init(values);
+    for (auto _ : state)
+        matrix.savetxt(mat, path, ',', "");
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_savetxt)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_savetxt_legacy(benchmark::State &state) {
+    // Same Matrix printed with operator<<, the 6 decimal strings of to_string()
+    std::string path = (std::filesystem::temp_directory_path() / "BM_savetxt.csv").string();
+    std::vector<std::vector<double>> values(40000, std::vector<double>(20));
+    for (int i = 0; i < 40000; i++)
+        for (int j = 0; j < 20; j++)
+            values[i][j] = std::sin(i * 20.0 + j) * 1000;
+    Matrix mat = matrix.init(values);
+    for (auto _ : state) {
+        std::ofstream file(path);
+        file << mat;
+    }
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_savetxt_legacy)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_csv_chunk_reader(benchmark::State &state) {
+    // Column statistics of about 16 MB of values read in chunks of 4096 rows
+    std::string path = (std::filesystem::temp_directory_path() / "BM_csv_chunks.csv").string();
+    {
+        std::ofstream file(path);
+        file.precision(17);
+        for (int i = 0; i < 40000; i++)
+            for (int j = 0; j < 20; j++)
+                file << std::sin(i * 20.0 + j) * 1000 << ((j == 19) ? '\n' : ',');
+    }
+    for (auto _ : state) {
+        CsvChunkReader reader(path, ',', 0, 4096);
+        Matrix chunk;
+        RunningStats stats;
+        while (reader.next(chunk))
+            stats.update(chunk);
+        benchmark::DoNotOptimize(stats.std());
+    }
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_csv_chunk_reader)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// 20000 rows of 200 columns, the first one a label from 0 to 9
+static void write_wide_csv(const std::string &path) {
+    std::ofstream file(path, std::ios::binary);
+    char cell[32];
+    for (int i = 0; i < 20000; i++) {
+        std::string line = std::to_string(i % 10);
+        for (int j = 1; j < 200; j++) {
+            std::snprintf(cell, sizeof(cell), ",%.6g", std::sin(i * 200.0 + j) * 100);
+            line += cell;
+        }
+        file << line << '\n';
+    }
+}
+
+static void BM_genfromtxt_pushdown(benchmark::State &state) {
+    // 5 of the 200 columns, for the rows of one label
+    std::string path = (std::filesystem::temp_directory_path() / "BM_genfromtxt_wide.csv").string();
+    write_wide_csv(path);
+    CsvOptions options;
+    options.usecols = {1, 2, 3, 4, 5};
+    options.filters = {{0, "==", "3"}};
+    for (auto _ : state)
+        matrix.genfromtxt(path, options);
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_genfromtxt_pushdown)->Unit(benchmark::kMillisecond);
+
+static void BM_genfromtxt_pushdown_legacy(benchmark::State &state) {
+    // Load all the columns, then slice the 5 columns and select the rows of one label
+    std::string path = (std::filesystem::temp_directory_path() / "BM_genfromtxt_wide.csv").string();
+    write_wide_csv(path);
+    for (auto _ : state) {
+        Matrix mat = matrix.genfromtxt(path, ',', 0);
+        Matrix label = mat.slice(0, mat.row_length(), 0, 1);
+        Matrix cols = mat.slice(0, mat.row_length(), 1, 6);
+        for (int j = 0; j < 5; j++)
+            matrix.slice_select(cols, label, 3, j);
+    }
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_genfromtxt_pushdown_legacy)->Unit(benchmark::kMillisecond);
+
+static void BM_genfromtxt_parallel(benchmark::State &state) {
+    // About 1 GB of values with 9 significant digits, parsed on state.range(0) threads
+    std::string path = (std::filesystem::temp_directory_path() / "BM_genfromtxt_1GB.csv").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        std::string line;
+        char cell[32];
+        for (int i = 0; i < 5000000; i++) {
+            line.clear();
+            for (int j = 0; j < 20; j++) {
+                std::snprintf(cell, sizeof(cell), "%.9g%c", std::sin(i * 20.0 + j) * 1000,
+                              (j == 19) ? '\n' : ',');
+                line += cell;
+            }
+            file << line;
+        }
+    }
+    for (auto _ : state)
+        matrix.genfromtxt(path, ',', 0, state.range(0));
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_genfromtxt_parallel)
+    ->RangeMultiplier(2)
+    ->Range(1, std::max(1u, std::thread::hardware_concurrency()))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
 static void BM_get(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     Matrix sliced_mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
@@ -364,6 +872,18 @@ static void BM_inverse(benchmark::State &state) {
 }
 BENCHMARK(BM_inverse);
 
+static void BM_inverse_large(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix sq_mat = matrix.init(vec);
+    for (auto _ : state)
+        matrix.inverse(sq_mat);
+}
+BENCHMARK(BM_inverse_large)->RangeMultiplier(4)->Range(16, 256);
+
 static void BM_log(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     Matrix sliced_mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
@@ -438,6 +958,57 @@ static void BM_min_row(benchmark::State &state) {
 }
 BENCHMARK(BM_min_row);
 
+/// (40000, 20) Matrix of doubles with one value in 20 missing
+static Matrix dirty_matrix() {
+    std::vector<std::vector<double>> values(40000, std::vector<double>(20));
+    for (int i = 0; i < 40000; i++)
+        for (int j = 0; j < 20; j++)
+            values[i][j] = (j == i % 20) ? std::numeric_limits<double>::quiet_NaN()
+                                         : std::sin(i * 20.0 + j);
+    return matrix.init(values);
+}
+
+static void BM_nanmean_column(benchmark::State &state) {
+    Matrix mat = dirty_matrix();
+    for (auto _ : state)
+        matrix.nanmean(mat, "column");
+}
+BENCHMARK(BM_nanmean_column)->Unit(benchmark::kMicrosecond);
+
+static void BM_nanmean_row(benchmark::State &state) {
+    Matrix mat = dirty_matrix();
+    for (auto _ : state)
+        matrix.nanmean(mat, "row");
+}
+BENCHMARK(BM_nanmean_row)->Unit(benchmark::kMicrosecond);
+
+static void BM_nanstd_column(benchmark::State &state) {
+    Matrix mat = dirty_matrix();
+    for (auto _ : state)
+        matrix.nanstd(mat, "column");
+}
+BENCHMARK(BM_nanstd_column)->Unit(benchmark::kMicrosecond);
+
+static void BM_nanargmax_column(benchmark::State &state) {
+    Matrix mat = dirty_matrix();
+    for (auto _ : state)
+        matrix.nanargmax(mat, "column");
+}
+BENCHMARK(BM_nanargmax_column)->Unit(benchmark::kMicrosecond);
+
+static void BM_nanmean_clean_legacy(benchmark::State &state) {
+    // matrix.mean() of the same Matrix with the NaN values replaced by 0 first
+    Matrix mat = dirty_matrix();
+    for (auto _ : state) {
+        Matrix clean = mat;
+        for (std::vector<double> &row : clean.double_mat)
+            for (double &v : row)
+                v = std::isnan(v) ? 0 : v;
+        matrix.mean(clean, "column");
+    }
+}
+BENCHMARK(BM_nanmean_clean_legacy)->Unit(benchmark::kMicrosecond);
+
 static void BM_ones(benchmark::State &state) {
     for (auto _ : state)
         matrix.ones(3, 4);
@@ -465,6 +1036,18 @@ static void BM_power_mat_sca(benchmark::State &state) {
 }
 BENCHMARK(BM_power_mat_sca);
 
+static void BM_randomized_svd(benchmark::State &state) {
+    int m = state.range(0), n = 256;
+    std::vector<std::vector<double>> vec(m, std::vector<double>(n));
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.randomized_svd(A, 10, 10, 2);
+}
+BENCHMARK(BM_randomized_svd)->RangeMultiplier(4)->Range(1024, 16384);
+
 static void BM_reciprocal(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     Matrix sliced_mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
@@ -492,6 +1075,73 @@ static void BM_slice_select(benchmark::State &state) {
 }
 BENCHMARK(BM_slice_select);
 
+static void BM_solve(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix A = matrix.init(vec);
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.solve(A, b);
+}
+BENCHMARK(BM_solve)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_solve_mixed(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix A = matrix.init(vec);
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.solve_mixed(A, b);
+}
+BENCHMARK(BM_solve_mixed)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_solve_reuse(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    LU factors = matrix.lu(matrix.init(vec));
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        factors.solve(b);
+}
+BENCHMARK(BM_solve_reuse)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_sparse_matmul(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            if ((i * 7 + j * 13) % 100 == 0)
+                vec[i][j] = 1 + i - j;
+    SparseMatrix A = matrix.sparse(matrix.init(vec));
+    Matrix x = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.matmul(A, x);
+}
+BENCHMARK(BM_sparse_matmul)->RangeMultiplier(4)->Range(64, 4096);
+
+static void BM_sparse_add(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            if ((i * 7 + j * 13) % 100 == 0)
+                vec[i][j] = 1 + i - j;
+    SparseMatrix A = matrix.sparse(matrix.init(vec));
+    SparseMatrix B = A.T();
+    for (auto _ : state)
+        A + B;
+}
+BENCHMARK(BM_sparse_add)->RangeMultiplier(4)->Range(64, 4096);
+
 static void BM_sqrt(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     Matrix sliced_mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
@@ -537,6 +1187,30 @@ static void BM_sum_row(benchmark::State &state) {
 }
 BENCHMARK(BM_sum_row);
 
+static void BM_svd(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(4 * n, std::vector<double>(n));
+    for (int i = 0; i < 4 * n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.svd(A);
+}
+BENCHMARK(BM_svd)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_svd_top_k(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(4 * n, std::vector<double>(n));
+    for (int i = 0; i < 4 * n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.svd(A, 10);
+}
+BENCHMARK(BM_svd_top_k)->RangeMultiplier(4)->Range(16, 256);
+
 static void BM_T(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     for (auto _ : state)
@@ -552,6 +1226,13 @@ static void BM_to_double(benchmark::State &state) {
 }
 BENCHMARK(BM_to_double);
 
+static void BM_to_string(benchmark::State &state) {
+    Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1);
+    for (auto _ : state)
+        mat.to_string();
+}
+BENCHMARK(BM_to_string);
+
 static void BM_unary_minus(benchmark::State &state) {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
     Matrix sliced_mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
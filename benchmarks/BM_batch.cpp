@@ -0,0 +1,42 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_batch_inverse(benchmark::State &state) {
+    int count = state.range(0), n = 4;
+    std::vector<double> tensor(count * n * n);
+    for (int k = 0; k < count * n * n; k++)
+        tensor[k] = std::sin(k * 0.37) + ((k % (n * n)) % (n + 1) == 0 ? n : 0);
+    MatrixBatch batch = matrix.batch(tensor, count, n, n);
+    for (auto _ : state)
+        matrix.inverse(batch);
+}
+BENCHMARK(BM_batch_inverse)->RangeMultiplier(8)->Range(64, 32768);
+
+static void BM_batch_inverse_loop(benchmark::State &state) {
+    int count = state.range(0), n = 4;
+    std::vector<Matrix> mats;
+    for (int b = 0; b < count; b++) {
+        std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                vec[i][j] = std::sin(((b * n + i) * n + j) * 0.37) + (i == j ? n : 0);
+        mats.push_back(matrix.init(vec));
+    }
+    for (auto _ : state)
+        for (Matrix &mat : mats)
+            matrix.inverse(mat);
+}
+BENCHMARK(BM_batch_inverse_loop)->RangeMultiplier(8)->Range(64, 32768);
+
+static void BM_batch_determinant(benchmark::State &state) {
+    int count = state.range(0), n = 4;
+    std::vector<double> tensor(count * n * n);
+    for (int k = 0; k < count * n * n; k++)
+        tensor[k] = std::sin(k * 0.37) + ((k % (n * n)) % (n + 1) == 0 ? n : 0);
+    MatrixBatch batch = matrix.batch(tensor, count, n, n);
+    for (auto _ : state)
+        matrix.determinant(batch);
+}
+BENCHMARK(BM_batch_determinant)->RangeMultiplier(8)->Range(64, 32768);
+
+BENCHMARK_MAIN();
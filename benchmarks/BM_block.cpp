@@ -0,0 +1,37 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_block(benchmark::State &state) {
+    int n = state.range(0);
+    Matrix A = matrix.ones(n, n), B = matrix.zeros(n, n), C = matrix.eye(n);
+    for (auto _ : state)
+        matrix.block({{A, B}, {B, C}});
+}
+BENCHMARK(BM_block)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_block_concatenate(benchmark::State &state) {
+    int n = state.range(0);
+    Matrix A = matrix.ones(n, n), B = matrix.zeros(n, n), C = matrix.eye(n);
+    for (auto _ : state)
+        matrix.concatenate(matrix.concatenate(A, B, "column"), matrix.concatenate(B, C, "column"),
+                           "row");
+}
+BENCHMARK(BM_block_concatenate)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_kron(benchmark::State &state) {
+    int n = state.range(0);
+    Matrix A = matrix.eye(4), B = matrix.ones(n, n);
+    for (auto _ : state)
+        matrix.kron(A, B);
+}
+BENCHMARK(BM_kron)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_outer(benchmark::State &state) {
+    int n = state.range(0);
+    Matrix u = matrix.ones(n, 1), v = matrix.ones(1, n);
+    for (auto _ : state)
+        matrix.outer(u, v);
+}
+BENCHMARK(BM_outer)->RangeMultiplier(4)->Range(16, 1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,41 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_cg(benchmark::State &state) {
+    int g = state.range(0), n = g * g;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    for (int i = 0; i < g; i++) {
+        for (int j = 0; j < g; j++) {
+            int k = i * g + j;
+            vec[k][k] = 4;
+            if (i > 0)
+                vec[k][k - g] = vec[k - g][k] = -1;
+            if (j > 0)
+                vec[k][k - 1] = vec[k - 1][k] = -1;
+        }
+    }
+    Matrix A = matrix.init(vec);
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.cg(A, b, 1e-8, 10000, "ichol");
+}
+BENCHMARK(BM_cg)->RangeMultiplier(2)->Range(8, 32);
+
+static void BM_cg_operator(benchmark::State &state) {
+    int g = state.range(0), n = g * g;
+    LinearOperator laplacian = [g](const double *x, double *y) {
+        for (int i = 0; i < g; i++) {
+            for (int j = 0; j < g; j++) {
+                int k = i * g + j;
+                y[k] = 4 * x[k] - ((i > 0) ? x[k - g] : 0) - ((i < g - 1) ? x[k + g] : 0) -
+                       ((j > 0) ? x[k - 1] : 0) - ((j < g - 1) ? x[k + 1] : 0);
+            }
+        }
+    };
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.cg(laplacian, b, 1e-8, 10000);
+}
+BENCHMARK(BM_cg_operator)->RangeMultiplier(4)->Range(16, 256);
+
+BENCHMARK_MAIN();
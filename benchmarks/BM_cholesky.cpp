@@ -0,0 +1,16 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_cholesky(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.cholesky(A);
+}
+BENCHMARK(BM_cholesky)->RangeMultiplier(4)->Range(16, 1024);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,40 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_eigh(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            vec[i][j] = vec[j][i] = std::sin(i * 0.37 + j * 1.3);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.eigh(A);
+}
+BENCHMARK(BM_eigh)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_eigh_top_k(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            vec[i][j] = vec[j][i] = std::sin(i * 0.37 + j * 1.3);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.eigh(A, 10);
+}
+BENCHMARK(BM_eigh_top_k)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_eigsh(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            vec[i][j] = vec[j][i] = std::sin(i * 0.37 + j * 1.3);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.eigsh(A, 10);
+}
+BENCHMARK(BM_eigsh)->RangeMultiplier(4)->Range(16, 1024);
+
+BENCHMARK_MAIN();
@@ -1,10 +1,238 @@
 #include <Matrix.hpp>
 #include <benchmark/benchmark.h>
 
+#include <filesystem>
+#include <thread>
+
 static void BM_genfromtxt(benchmark::State &state) {
     for (auto _ : state)
         matrix.genfromtxt("./datasets/boston/boston.csv",',');
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/boston/boston.csv"));
 }
 BENCHMARK(BM_genfromtxt);
 
+static void BM_genfromtxt_to_double(benchmark::State &state) {
+    for (auto _ : state) {
+        Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
+        mat = mat.slice(1, mat.row_length(), 0, mat.col_length());
+        mat.to_double();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/boston/boston.csv"));
+}
+BENCHMARK(BM_genfromtxt_to_double);
+
+static void BM_genfromtxt_numeric(benchmark::State &state) {
+    for (auto _ : state)
+        matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1);
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/boston/boston.csv"));
+}
+BENCHMARK(BM_genfromtxt_numeric);
+
+static void BM_genfromtxt_table(benchmark::State &state) {
+    CsvOptions options;
+    options.names = true;
+    for (auto _ : state)
+        matrix.genfromtxt("./datasets/wine/wine.csv", options);
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/wine/wine.csv"));
+}
+BENCHMARK(BM_genfromtxt_table);
+
+static void BM_genfromtxt_table_legacy(benchmark::State &state) {
+    // Load as strings, slice the header and the label column away, then convert
+    for (auto _ : state) {
+        Matrix mat = matrix.genfromtxt("./datasets/wine/wine.csv", ',');
+        mat = mat.slice(1, mat.row_length(), 0, mat.col_length() - 1);
+        mat.to_double();
+    }
+    state.SetBytesProcessed(state.iterations() *
+                            std::filesystem::file_size("./datasets/wine/wine.csv"));
+}
+BENCHMARK(BM_genfromtxt_table_legacy);
+
+static void BM_load(benchmark::State &state) {
+    // Opening a binary file of state.range(0) rows of 100 columns, without reading the values
+    std::string path = (std::filesystem::temp_directory_path() / "BM_load.bin").string();
+    matrix.save(matrix.zeros(state.range(0), 100), path);
+    for (auto _ : state)
+        benchmark::DoNotOptimize(matrix.load(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_load)->Arg(1000)->Arg(10000)->Arg(100000);
+
+static void BM_load_boston(benchmark::State &state) {
+    // Opening boston.csv saved as binary and reading every value, against BM_genfromtxt_numeric
+    std::string path = (std::filesystem::temp_directory_path() / "BM_load_boston.bin").string();
+    matrix.save(matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1), path);
+    for (auto _ : state) {
+        MatrixView view = matrix.load(path);
+        benchmark::DoNotOptimize(view.verify());
+    }
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_load_boston);
+
+static void BM_load_npy(benchmark::State &state) {
+    // Opening boston.csv saved as .npy and reading every value
+    std::string path = (std::filesystem::temp_directory_path() / "BM_load_boston.npy").string();
+    matrix.save_npy(matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1), path);
+    for (auto _ : state) {
+        MatrixView view = matrix.load_npy(path);
+        double sum = 0;
+        for (size_t k = 0; k < static_cast<size_t>(view.rows) * view.cols; k++)
+            sum += view.data[k];
+        benchmark::DoNotOptimize(sum);
+    }
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_load_npy);
+
+static void BM_genfromtxt_numeric_large(benchmark::State &state) {
+    // About 16 MB of random values with full precision
+    std::string path = (std::filesystem::temp_directory_path() / "BM_genfromtxt.csv").string();
+    {
+        std::ofstream file(path);
+        file.precision(17);
+        for (int i = 0; i < 40000; i++)
+            for (int j = 0; j < 20; j++)
+                file << std::sin(i * 20.0 + j) * 1000 << ((j == 19) ? '\n' : ',');
+    }
+    for (auto _ : state)
+        matrix.genfromtxt(path, ',', 0);
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_genfromtxt_numeric_large)->Unit(benchmark::kMillisecond);
+
+static void BM_savetxt(benchmark::State &state) {
+    // The 16 MB of BM_genfromtxt_numeric_large written back with full precision
+    std::string path = (std::filesystem::temp_directory_path() / "BM_savetxt.csv").string();
+    std::vector<std::vector<double>> values(40000, std::vector<double>(20));
+    for (int i = 0; i < 40000; i++)
+        for (int j = 0; j < 20; j++)
+            values[i][j] = std::sin(i * 20.0 + j) * 1000;
+    Matrix mat = matrix.init(values);
+    for (auto _ : state)
+        matrix.savetxt(mat, path, ',', "");
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_savetxt)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_savetxt_legacy(benchmark::State &state) {
+    // Same Matrix printed with operator<<, the 6 decimal strings of to_string()
+    std::string path = (std::filesystem::temp_directory_path() / "BM_savetxt.csv").string();
+    std::vector<std::vector<double>> values(40000, std::vector<double>(20));
+    for (int i = 0; i < 40000; i++)
+        for (int j = 0; j < 20; j++)
+            values[i][j] = std::sin(i * 20.0 + j) * 1000;
+    Matrix mat = matrix.init(values);
+    for (auto _ : state) {
+        std::ofstream file(path);
+        file << mat;
+    }
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_savetxt_legacy)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+static void BM_csv_chunk_reader(benchmark::State &state) {
+    // Column statistics of about 16 MB of values read in chunks of 4096 rows
+    std::string path = (std::filesystem::temp_directory_path() / "BM_csv_chunks.csv").string();
+    {
+        std::ofstream file(path);
+        file.precision(17);
+        for (int i = 0; i < 40000; i++)
+            for (int j = 0; j < 20; j++)
+                file << std::sin(i * 20.0 + j) * 1000 << ((j == 19) ? '\n' : ',');
+    }
+    for (auto _ : state) {
+        CsvChunkReader reader(path, ',', 0, 4096);
+        Matrix chunk;
+        RunningStats stats;
+        while (reader.next(chunk))
+            stats.update(chunk);
+        benchmark::DoNotOptimize(stats.std());
+    }
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_csv_chunk_reader)->UseRealTime()->Unit(benchmark::kMillisecond);
+
+// 20000 rows of 200 columns, the first one a label from 0 to 9
+static void write_wide_csv(const std::string &path) {
+    std::ofstream file(path, std::ios::binary);
+    char cell[32];
+    for (int i = 0; i < 20000; i++) {
+        std::string line = std::to_string(i % 10);
+        for (int j = 1; j < 200; j++) {
+            std::snprintf(cell, sizeof(cell), ",%.6g", std::sin(i * 200.0 + j) * 100);
+            line += cell;
+        }
+        file << line << '\n';
+    }
+}
+
+static void BM_genfromtxt_pushdown(benchmark::State &state) {
+    // 5 of the 200 columns, for the rows of one label
+    std::string path = (std::filesystem::temp_directory_path() / "BM_genfromtxt_wide.csv").string();
+    write_wide_csv(path);
+    CsvOptions options;
+    options.usecols = {1, 2, 3, 4, 5};
+    options.filters = {{0, "==", "3"}};
+    for (auto _ : state)
+        matrix.genfromtxt(path, options);
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_genfromtxt_pushdown)->Unit(benchmark::kMillisecond);
+
+static void BM_genfromtxt_pushdown_legacy(benchmark::State &state) {
+    // Load all the columns, then slice the 5 columns and select the rows of one label
+    std::string path = (std::filesystem::temp_directory_path() / "BM_genfromtxt_wide.csv").string();
+    write_wide_csv(path);
+    for (auto _ : state) {
+        Matrix mat = matrix.genfromtxt(path, ',', 0);
+        Matrix label = mat.slice(0, mat.row_length(), 0, 1);
+        Matrix cols = mat.slice(0, mat.row_length(), 1, 6);
+        for (int j = 0; j < 5; j++)
+            matrix.slice_select(cols, label, 3, j);
+    }
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+BENCHMARK(BM_genfromtxt_pushdown_legacy)->Unit(benchmark::kMillisecond);
+
+static void BM_genfromtxt_parallel(benchmark::State &state) {
+    // About 1 GB of values with 9 significant digits, parsed on state.range(0) threads
+    std::string path = (std::filesystem::temp_directory_path() / "BM_genfromtxt_1GB.csv").string();
+    {
+        std::ofstream file(path, std::ios::binary);
+        std::string line;
+        char cell[32];
+        for (int i = 0; i < 5000000; i++) {
+            line.clear();
+            for (int j = 0; j < 20; j++) {
+                std::snprintf(cell, sizeof(cell), "%.9g%c", std::sin(i * 20.0 + j) * 1000,
+                              (j == 19) ? '\n' : ',');
+                line += cell;
+            }
+            file << line;
+        }
+    }
+    for (auto _ : state)
+        matrix.genfromtxt(path, ',', 0, state.range(0));
+    state.SetBytesProcessed(state.iterations() * std::filesystem::file_size(path));
+    std::filesystem::remove(path);
+}
+
+BENCHMARK(BM_genfromtxt_parallel)
+    ->RangeMultiplier(2)
+    ->Range(1, std::max(1u, std::thread::hardware_concurrency()))
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
 BENCHMARK_MAIN();
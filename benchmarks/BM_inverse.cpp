@@ -10,4 +10,16 @@ static void BM_inverse(benchmark::State &state) {
 }
 BENCHMARK(BM_inverse);
 
+static void BM_inverse_large(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix sq_mat = matrix.init(vec);
+    for (auto _ : state)
+        matrix.inverse(sq_mat);
+}
+BENCHMARK(BM_inverse_large)->RangeMultiplier(4)->Range(16, 256);
+
 BENCHMARK_MAIN();
@@ -0,0 +1,29 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_lstsq(benchmark::State &state) {
+    Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
+    Matrix X = mat.slice(1, mat.row_length(), 0, mat.col_length() - 1);
+    Matrix y = mat.slice(1, mat.row_length(), mat.col_length() - 1, mat.col_length());
+    X.to_double();
+    y.to_double();
+    for (auto _ : state)
+        matrix.lstsq(X, y);
+}
+BENCHMARK(BM_lstsq);
+
+static void BM_lstsq_tall(benchmark::State &state) {
+    int m = state.range(0), n = 20;
+    std::vector<std::vector<double>> x(m, std::vector<double>(n)), y(m, std::vector<double>(1));
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++)
+            x[i][j] = std::cos(i * (j + 0.5));
+        y[i][0] = std::sin(i);
+    }
+    Matrix X = matrix.init(x), Y = matrix.init(y);
+    for (auto _ : state)
+        matrix.lstsq(X, Y);
+}
+BENCHMARK(BM_lstsq_tall)->RangeMultiplier(10)->Range(1000, 100000);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,29 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+#include <thread>
+
+static void BM_lu_threads(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+    int threads = matrix.get_num_threads();
+    matrix.set_num_threads(state.range(1));
+    for (auto _ : state)
+        matrix.lu(A);
+    matrix.set_num_threads(threads);
+    double flops = 2.0 / 3 * n * n * n * state.iterations();
+    state.counters["GFlops"] = benchmark::Counter(flops / 1e9, benchmark::Counter::kIsRate);
+}
+
+// Powers of two threads up to all cores
+BENCHMARK(BM_lu_threads)
+    ->RangeMultiplier(2)
+    ->Ranges({{1024, 4096}, {1, std::max(1u, std::thread::hardware_concurrency())}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,40 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_multi_dot(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> a(n, std::vector<double>(10)), b(10, std::vector<double>(n)),
+        c(n, std::vector<double>(5));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 10; j++) {
+            a[i][j] = i + j;
+            b[j][i] = i - j;
+        }
+        for (int j = 0; j < 5; j++)
+            c[i][j] = i * j;
+    }
+    Matrix A = matrix.init(a), B = matrix.init(b), C = matrix.init(c);
+    for (auto _ : state)
+        matrix.multi_dot({A, B, C});
+}
+BENCHMARK(BM_multi_dot)->RangeMultiplier(4)->Range(16, 1024);
+
+static void BM_multi_dot_nested(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> a(n, std::vector<double>(10)), b(10, std::vector<double>(n)),
+        c(n, std::vector<double>(5));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < 10; j++) {
+            a[i][j] = i + j;
+            b[j][i] = i - j;
+        }
+        for (int j = 0; j < 5; j++)
+            c[i][j] = i * j;
+    }
+    Matrix A = matrix.init(a), B = matrix.init(b), C = matrix.init(c);
+    for (auto _ : state)
+        matrix.matmul(matrix.matmul(A, B), C);
+}
+BENCHMARK(BM_multi_dot_nested)->RangeMultiplier(4)->Range(16, 1024);
+
+BENCHMARK_MAIN();
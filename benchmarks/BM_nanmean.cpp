@@ -0,0 +1,56 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+#include <limits>
+
+/// (40000, 20) Matrix of doubles with one value in 20 missing
+static Matrix dirty_matrix() {
+    std::vector<std::vector<double>> values(40000, std::vector<double>(20));
+    for (int i = 0; i < 40000; i++)
+        for (int j = 0; j < 20; j++)
+            values[i][j] = (j == i % 20) ? std::numeric_limits<double>::quiet_NaN()
+                                         : std::sin(i * 20.0 + j);
+    return matrix.init(values);
+}
+
+static void BM_nanmean_column(benchmark::State &state) {
+    Matrix mat = dirty_matrix();
+    for (auto _ : state)
+        matrix.nanmean(mat, "column");
+}
+BENCHMARK(BM_nanmean_column)->Unit(benchmark::kMicrosecond);
+
+static void BM_nanmean_row(benchmark::State &state) {
+    Matrix mat = dirty_matrix();
+    for (auto _ : state)
+        matrix.nanmean(mat, "row");
+}
+BENCHMARK(BM_nanmean_row)->Unit(benchmark::kMicrosecond);
+
+static void BM_nanstd_column(benchmark::State &state) {
+    Matrix mat = dirty_matrix();
+    for (auto _ : state)
+        matrix.nanstd(mat, "column");
+}
+BENCHMARK(BM_nanstd_column)->Unit(benchmark::kMicrosecond);
+
+static void BM_nanargmax_column(benchmark::State &state) {
+    Matrix mat = dirty_matrix();
+    for (auto _ : state)
+        matrix.nanargmax(mat, "column");
+}
+BENCHMARK(BM_nanargmax_column)->Unit(benchmark::kMicrosecond);
+
+static void BM_nanmean_clean_legacy(benchmark::State &state) {
+    // matrix.mean() of the same Matrix with the NaN values replaced by 0 first
+    Matrix mat = dirty_matrix();
+    for (auto _ : state) {
+        Matrix clean = mat;
+        for (std::vector<double> &row : clean.double_mat)
+            for (double &v : row)
+                v = std::isnan(v) ? 0 : v;
+        matrix.mean(clean, "column");
+    }
+}
+BENCHMARK(BM_nanmean_clean_legacy)->Unit(benchmark::kMicrosecond);
+
+BENCHMARK_MAIN();
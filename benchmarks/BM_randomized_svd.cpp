@@ -0,0 +1,16 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_randomized_svd(benchmark::State &state) {
+    int m = state.range(0), n = 256;
+    std::vector<std::vector<double>> vec(m, std::vector<double>(n));
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.randomized_svd(A, 10, 10, 2);
+}
+BENCHMARK(BM_randomized_svd)->RangeMultiplier(4)->Range(1024, 16384);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,43 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_solve(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix A = matrix.init(vec);
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.solve(A, b);
+}
+BENCHMARK(BM_solve)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_solve_mixed(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix A = matrix.init(vec);
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.solve_mixed(A, b);
+}
+BENCHMARK(BM_solve_mixed)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_solve_reuse(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    LU factors = matrix.lu(matrix.init(vec));
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        factors.solve(b);
+}
+BENCHMARK(BM_solve_reuse)->RangeMultiplier(4)->Range(16, 256);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,32 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_sparse_matmul(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            if ((i * 7 + j * 13) % 100 == 0)
+                vec[i][j] = 1 + i - j;
+    SparseMatrix A = matrix.sparse(matrix.init(vec));
+    Matrix x = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.matmul(A, x);
+}
+BENCHMARK(BM_sparse_matmul)->RangeMultiplier(4)->Range(64, 4096);
+
+static void BM_sparse_add(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            if ((i * 7 + j * 13) % 100 == 0)
+                vec[i][j] = 1 + i - j;
+    SparseMatrix A = matrix.sparse(matrix.init(vec));
+    SparseMatrix B = A.T();
+    for (auto _ : state)
+        A + B;
+}
+BENCHMARK(BM_sparse_add)->RangeMultiplier(4)->Range(64, 4096);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,43 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_diagonal_matmul(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    DiagonalMatrix D = matrix.diag(matrix.init(vec));
+    Matrix B = matrix.ones(n, n);
+    for (auto _ : state)
+        matrix.matmul(D, B);
+}
+BENCHMARK(BM_diagonal_matmul)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_triangular_solve(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    TriangularMatrix T = matrix.tril(matrix.init(vec));
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.solve(T, b);
+}
+BENCHMARK(BM_triangular_solve)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_symmetric_solve(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    SymmetricMatrix S = matrix.symmetric(matrix.init(vec));
+    Matrix b = matrix.ones(n, 1);
+    for (auto _ : state)
+        matrix.solve(S, b);
+}
+BENCHMARK(BM_symmetric_solve)->RangeMultiplier(4)->Range(16, 256);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,28 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_svd(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(4 * n, std::vector<double>(n));
+    for (int i = 0; i < 4 * n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.svd(A);
+}
+BENCHMARK(BM_svd)->RangeMultiplier(4)->Range(16, 256);
+
+static void BM_svd_top_k(benchmark::State &state) {
+    int n = state.range(0);
+    std::vector<std::vector<double>> vec(4 * n, std::vector<double>(n));
+    for (int i = 0; i < 4 * n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+    for (auto _ : state)
+        matrix.svd(A, 10);
+}
+BENCHMARK(BM_svd_top_k)->RangeMultiplier(4)->Range(16, 256);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,11 @@
+#include <Matrix.hpp>
+#include <benchmark/benchmark.h>
+
+static void BM_to_string(benchmark::State &state) {
+    Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1);
+    for (auto _ : state)
+        mat.to_string();
+}
+BENCHMARK(BM_to_string);
+
+BENCHMARK_MAIN();
@@ -0,0 +1,27 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Build a batch of 1000 small 3x3 Matrix objects from a contiguous tensor.
+The determinants and inverses of the whole batch are calculated at once, and
+one of the inverses is checked against the inverse of the single Matrix.
+*/
+int main() {
+    int count = 1000, n = 3;
+    std::vector<double> tensor(count * n * n);
+    for (int k = 0; k < count * n * n; k++)
+        tensor[k] = (k * 7) % 10 + ((k % (n * n)) % (n + 1) == 0 ? 5 : 0);
+    MatrixBatch batch = matrix.batch(tensor, count, n, n);
+
+    // Determinant and Inverse of every Matrix of the batch
+    std::vector<double> det = matrix.determinant(batch);
+    MatrixBatch inv = matrix.inverse(batch);
+    std::cout << "Determinant of Matrix 42: " << det[42] << std::endl;
+    inv.get(42).print();
+
+    // Same Matrix on its own
+    Matrix single = batch.get(42);
+    matrix.inverse(single).print();
+
+    return 0;
+}
@@ -0,0 +1,47 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Build the 2D Laplacian of a 30 x 30 grid as a Matrix object and solve a
+Poisson problem with conjugate gradients, without and with an incomplete
+Cholesky preconditioner. The same system is then solved matrix-free, with
+the Laplacian given as a stencil. The iterations and residuals are printed.
+*/
+int main() {
+    int g = 30, n = g * g;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    for (int i = 0; i < g; i++) {
+        for (int j = 0; j < g; j++) {
+            int k = i * g + j;
+            vec[k][k] = 4;
+            if (i > 0)
+                vec[k][k - g] = vec[k - g][k] = -1;
+            if (j > 0)
+                vec[k][k - 1] = vec[k - 1][k] = -1;
+        }
+    }
+    Matrix A = matrix.init(vec);
+    Matrix b = matrix.ones(n, 1);
+
+    // Solving with the Matrix object
+    CG plain = matrix.cg(A, b, 1e-8, 1000);
+    CG ichol = matrix.cg(A, b, 1e-8, 1000, "ichol");
+    std::cout << plain.iterations << " " << plain.residual << std::endl;
+    std::cout << ichol.iterations << " " << ichol.residual << std::endl;
+
+    // Solving with a matrix-free operator
+    LinearOperator laplacian = [g](const double *x, double *y) {
+        for (int i = 0; i < g; i++) {
+            for (int j = 0; j < g; j++) {
+                int k = i * g + j;
+                y[k] = 4 * x[k] - ((i > 0) ? x[k - g] : 0) - ((i < g - 1) ? x[k + g] : 0) -
+                       ((j > 0) ? x[k - 1] : 0) - ((j < g - 1) ? x[k + 1] : 0);
+            }
+        }
+    };
+    CG free = matrix.cg(laplacian, b, 1e-8, 1000);
+    std::cout << free.iterations << " " << free.residual << std::endl;
+    free.x.slice(0, 5, 0, 1).print();
+
+    return 0;
+}
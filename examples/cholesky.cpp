@@ -0,0 +1,29 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Read csv files to get a Matrix object.
+Build the ridge regression normal equations (X^T * X + I) * w = X^T * y,
+which form a symmetric positive definite system.
+The system is solved with the Cholesky factorization and the weights are printed.
+*/
+int main() {
+    Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv",',');
+
+    Matrix X = mat.slice(1, mat.row_length(), 0, mat.col_length() - 1);
+    Matrix y = mat.slice(1, mat.row_length(), mat.col_length() - 1, mat.col_length());
+    X.to_double();
+    y.to_double();
+
+    // Solving the normal equations
+    Matrix XtX = matrix.matmul(X.T(), X) + matrix.eye(X.col_length());
+    Cholesky factors = matrix.cholesky(XtX);
+    if (!factors.positive_definite)
+        std::cout << "The Matrix is not positive definite, LU was used instead" << std::endl;
+    Matrix w = matrix.cho_solve(factors, matrix.matmul(X.T(), y));
+    w.print();
+
+    std::cout << "logdet = " << factors.logdet() << std::endl;
+
+    return 0;
+}
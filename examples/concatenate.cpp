@@ -8,6 +8,9 @@ The Matrix concatenation is done in two ways:
 
 1. row-wise
 2. column-wise
+
+A block Matrix is then assembled in one step, and Kronecker and outer products
+are calculated.
 */
 int main() {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv",',');
@@ -28,5 +31,17 @@ int main() {
     Matrix col_con = matrix.concatenate(matc0_3, matc5_9, "column");
     col_con.print();
 
+    std::cout << std::endl << std::endl;
+
+    // Assembling a block Matrix [[A, I], [0, A]] in one step
+    Matrix A = mat.slice(1, 3, 0, 2);
+    A.to_double();
+    Matrix block = matrix.block({{A, matrix.eye(2)}, {matrix.zeros(2, 2), A}});
+    block.print();
+
+    // Kronecker product and outer product
+    matrix.kron(matrix.eye(2), A).print();
+    matrix.outer(A.slice(0, 1, 0, 2), matrix.ones(3, 1)).print();
+
     return 0;
 }
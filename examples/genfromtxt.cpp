@@ -4,10 +4,53 @@
 
 Read a csv file and get a Matrix object
 The Matrix object is then printed to the console.
+Then read the iris dataset with its header and its string label column: the numeric columns are
+parsed straight into a Matrix of doubles and the labels are kept apart as strings.
+Then read only two columns of the virginica rows.
+Then read the boston dataset in chunks of 100 rows and get the mean of each column.
+Then write the iris numeric columns to a csv file with a header and read them back unchanged.
+Last, read a file with missing values as NaN and get the mean of each column without them.
 */
 int main() {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv",',');
     mat.print();
 
+    CsvOptions options;
+    options.names = true;
+    CsvTable iris = matrix.genfromtxt("./datasets/iris/iris.csv", options);
+    for (size_t k = 0; k < iris.names.size(); k++)
+        std::cout << iris.names[k] << ": " << iris.dtypes[k] << "\n";
+    Matrix features = iris.data.slice(0, 5, 0, iris.data.col_length());
+    features.print();
+    std::cout << "First label: " << iris.column("label").str_mat[0][0] << "\n";
+
+    options.usecols = {0, 2};
+    options.filters = {{5, "==", "virginica"}};
+    CsvTable virginica = matrix.genfromtxt("./datasets/iris/iris.csv", options);
+    std::cout << "virginica rows: " << virginica.data.row_length() << "\n";
+
+    CsvChunkReader reader("./datasets/boston/boston.csv", ',', 1, 100);
+    Matrix chunk;
+    RunningStats stats;
+    while (reader.next(chunk))
+        stats.update(chunk);
+    stats.mean().print();
+
+    std::string path = "iris_features.csv";
+    std::string header = "sepal_length,sepal_width,petal_length,petal_width,target";
+    matrix.savetxt(iris.data, path, ',', header);
+    Matrix saved = matrix.genfromtxt(path, ',', 1);
+    std::cout << "Same values: " << (saved.get() == iris.data.get()) << "\n";
+
+    std::ofstream(path) << "x,y\n1,NA\n,4\n3,8\n";
+    CsvOptions dirty;
+    dirty.names = true;
+    dirty.missing = {"", "NA"};
+    dirty.mask = true;
+    CsvTable table = matrix.genfromtxt(path, dirty);
+    std::cout << "Row 0 of y is valid: " << table.is_valid(0, 1) << "\n";
+    matrix.nanmean(table.data, "column").print();
+    std::remove(path.c_str());
+
     return 0;
 }
@@ -0,0 +1,25 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Read csv files to get a Matrix object.
+Slice the features and the target, and add a column of ones for the intercept.
+A linear model is fitted with least squares and the coefficients and the
+sum of squared residuals are printed.
+*/
+int main() {
+    Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv",',');
+
+    Matrix X = mat.slice(1, mat.row_length(), 0, mat.col_length() - 1);
+    Matrix y = mat.slice(1, mat.row_length(), mat.col_length() - 1, mat.col_length());
+    X.to_double();
+    y.to_double();
+    X = matrix.concatenate(matrix.ones(X.row_length(), 1), X, "column");
+
+    // Fitting a linear model
+    Lstsq fit = matrix.lstsq(X, y);
+    fit.coef.print();
+    fit.residuals.print();
+
+    return 0;
+}
@@ -5,6 +5,7 @@
 Read csv files to get a Matrix object.
 Slice the Matrix objects such that matrix multiplication is possible.
 The Matrix mulitplication is then performed and the result is printed.
+A chain of Matrix objects is then multiplied with multi_dot, in the cheapest order.
 */
 int main() {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv",',');
@@ -17,5 +18,11 @@ int main() {
     Matrix mul = matrix.matmul(mat1, mat2);
     mul.print();
 
+    // Multiplying a chain of Matrix objects
+    Matrix mat3 = mat.slice(10, 13, 0, 4);
+    mat3.to_double();
+    Matrix chain = matrix.multi_dot({mat1, mat2, mat3});
+    chain.print();
+
     return 0;
 }
@@ -0,0 +1,43 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Read csv files to get a Matrix object.
+Slice the pixel features of the digits dataset and center them.
+The top principal components are computed from the eigendecomposition of the
+covariance Matrix, from Lanczos iterations on the covariance Matrix, from the
+SVD of the centered data and from a randomized SVD, and the explained variances
+are printed.
+*/
+int main() {
+    Matrix mat = matrix.genfromtxt("./datasets/digits/digits.csv",',');
+
+    Matrix X = mat.slice(1, mat.row_length(), 0, mat.col_length() - 1);
+    X.to_double();
+    X = X - matrix.mean(X, "column");
+    int n_samples = X.row_length();
+
+    // Principal components from the covariance Matrix
+    Matrix cov = matrix.matmul(X.T(), X) / (n_samples - 1);
+    Eigh eig = matrix.eigh(cov, 10);
+    eig.values.print();
+
+    // Same components from Lanczos iterations, which only multiply by the covariance Matrix
+    Eigh lanczos = matrix.eigsh(cov, 10);
+    lanczos.values.print();
+
+    // Principal components from the centered data
+    SVD svd = matrix.svd(X, 10);
+    Matrix variance = matrix.power(svd.S, 2) / (n_samples - 1);
+    variance.print();
+
+    // Principal components from a seeded random sketch of the centered data
+    SVD sketch = matrix.randomized_svd(X, 10, 10, 2, 42);
+    (matrix.power(sketch.S, 2) / (n_samples - 1)).print();
+
+    // Projection of the data on the first two components
+    Matrix projected = matrix.matmul(X, svd.V.slice(0, svd.V.row_length(), 0, 2));
+    projected.slice(0, 5, 0, 2).print();
+
+    return 0;
+}
@@ -0,0 +1,30 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Parse a csv file once and save it as a binary Matrix file.
+Loading the binary file only maps it, the values are read when they are used.
+The same Matrix is then exchanged with NumPy as .npy and .npz files.
+*/
+int main() {
+    Matrix boston = matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1);
+    matrix.save(boston, "boston.bin");
+
+    MatrixView view = matrix.load("boston.bin");
+    std::cout << "Shape: (" << view.rows << ", " << view.cols << ")\n";
+    std::cout << "First value: " << view.get(0, 0) << "\n";
+    std::cout << "Checksum matches: " << (view.verify() ? "yes" : "no") << "\n";
+
+    Matrix mat = view.to_matrix();
+    mat.slice(0, 3, 0, mat.col_length()).print();
+
+    // numpy.load("boston.npy") and numpy.load("boston.npz")["features"] read these files
+    matrix.save_npy(boston, "boston.npy");
+    matrix.save_npz({{"features", boston}}, "boston.npz");
+    MatrixView npy = matrix.load_npy("boston.npy");
+    std::map<std::string, MatrixView> npz = matrix.load_npz("boston.npz");
+    std::cout << "Same values: " << (npy.get(10, 4) == npz["features"].get(10, 4) ? "yes" : "no")
+              << "\n";
+
+    return 0;
+}
@@ -0,0 +1,36 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Read csv files to get a Matrix object.
+Slice the Matrix objects to get a square system A * X = B.
+The system is solved without forming the inverse and the solution is printed.
+The LU factorization of A is then reused to solve a second right hand side.
+Finally the system is solved in mixed precision and the number of refinement
+steps is printed.
+*/
+int main() {
+    Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv",',');
+
+    // Solving a linear system
+    Matrix A = mat.slice(1, 4, 0, 3);
+    Matrix B = mat.slice(1, 4, 3, 5);
+    A.to_double();
+    B.to_double();
+    Matrix X = matrix.solve(A, B);
+    X.print();
+
+    // Reusing the factorization for another right hand side
+    LU factors = matrix.lu(A);
+    Matrix b = mat.slice(4, 7, 5, 6);
+    b.to_double();
+    Matrix x = factors.solve(b);
+    x.print();
+
+    // Single precision factorization refined in double precision
+    SolveMixed mixed = matrix.solve_mixed(A, B);
+    mixed.X.print();
+    std::cout << mixed.iterations << " " << mixed.fallback << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,25 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Read the pixels of the digits dataset straight into a SparseMatrix object,
+skipping the header line, and print how many values are stored.
+The pixel sums of the first images are computed with a sparse times dense
+product, and the first rows are converted back to a dense Matrix object.
+*/
+int main() {
+    SparseMatrix mat = matrix.genfromtxt_sparse("./datasets/digits/digits.csv", ',', 1);
+    std::cout << mat.row_length() << " x " << mat.col_length() << ", " << mat.nnz()
+              << " non-zero values" << std::endl;
+
+    // Sum of the pixels (and the target) of the first images
+    SparseMatrix first = mat.slice(0, 5);
+    Matrix sums = matrix.matmul(first, matrix.ones(first.col_length(), 1));
+    sums.print();
+
+    // Scaling keeps the Matrix sparse
+    SparseMatrix scaled = first / 16;
+    scaled.to_dense().view(0, 2, 0, 8);
+
+    return 0;
+}
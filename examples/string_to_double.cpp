@@ -5,6 +5,7 @@
 Read a csv file and get a Matrix object.
 Slice the Matrix object to remove the rows and columns which cannot be converted to double.
 The sliced Matrix object is then converted to double and printed to the console.
+Last, convert the whole Matrix object, header included, and print where its bad cells are.
 */
 int main() {
     Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv",',');
@@ -12,5 +13,10 @@ int main() {
     sliced_mat.to_double();
     sliced_mat.print();
 
+    std::vector<std::pair<int, int>> bad;
+    if (!mat.to_double(bad))
+        for (const std::pair<int, int> &cell : bad)
+            std::cout << "Not a number at (" << cell.first << ", " << cell.second << ")\n";
+
     return 0;
 }
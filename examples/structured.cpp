@@ -0,0 +1,29 @@
+#include <Matrix.hpp>
+
+/* Example program
+
+Build diagonal, triangular and symmetric Matrix objects from a dense Matrix.
+Only the needed values are stored, and matmul, solve, inverse and determinant
+use the structure instead of treating the Matrix as dense.
+*/
+int main() {
+    Matrix mat = matrix.init(std::vector<std::vector<double>>{{4, 1, 2}, {1, 5, 3}, {2, 3, 6}});
+    Matrix b = matrix.init(std::vector<std::vector<double>>{{1}, {2}, {3}});
+
+    // Diagonal times a Matrix scales its rows
+    DiagonalMatrix D = matrix.diag(mat);
+    matrix.matmul(D, mat).print();
+
+    // Triangular solve and Determinant as the product of the diagonal
+    TriangularMatrix L = matrix.tril(mat);
+    matrix.solve(L, b).print();
+    std::cout << "Determinant of L: " << matrix.determinant(L) << std::endl;
+
+    // Symmetric Matrix stored as its lower triangle
+    SymmetricMatrix S = matrix.symmetric(mat);
+    std::cout << "Stored values: " << S.data.size() << std::endl;
+    matrix.solve(S, b).print();
+    matrix.inverse(S).to_dense().print();
+
+    return 0;
+}
@@ -1,4 +1,7 @@
-#include <matrix_basic.hpp>
+#include <matrix_kernels.hpp>
+
+#include <limits>
+#include <mutex>
 
 /// Method to return the matrix in the form of vector
 std::vector<std::vector<double>> Matrix::get() {
@@ -138,29 +141,72 @@ Matrix Matrix::T() {
     return mat;
 }
 
-/// Method convert the elements of a Matrix from std::string to double
+/// Number of cells converted by one task of to_double() and to_string()
+static const int convert_grain = 4096;
+
+/// Method to return the number of rows converted by one task when the rows have cols cells
+static int convert_rows(size_t cols) {
+    return std::max<size_t>(1, convert_grain / std::max<size_t>(1, cols));
+}
+
+/** Method convert the elements of a Matrix from std::string to double
+   Every cell must be a number, otherwise the program stops. Use the overload taking a vector of
+   positions to find the bad cells instead.
+*/
 void Matrix::to_double() {
-    std::vector<double> row;
-    double_mat.clear();
-    for (int i = 0; i < str_mat.size(); i++) {
-        for (int j = 0; j < str_mat[i].size(); j++)
-            row.push_back(std::stod(str_mat[i][j]));
-        double_mat.push_back(row);
-        row.clear();
-    }
+    std::vector<std::pair<int, int>> bad;
+    if (!to_double(bad))
+        assert(("The Matrix contains cells that are not numbers", false));
+}
+
+/** Method convert the elements of a Matrix from std::string to double, reporting bad cells
+   Cells are parsed with std::from_chars on num_threads() threads and the rows of double_mat are
+   reused. A cell that is not a number becomes NaN and its (row, column) position is stored in
+   bad, in order. Returns true when every cell is a number.
+*/
+bool Matrix::to_double(std::vector<std::pair<int, int>> &bad) {
+    bad.clear();
+    std::mutex mutex;
+    double_mat.resize(str_mat.size());
+    int grain = convert_rows(str_mat.empty() ? 0 : str_mat[0].size());
+    kernels::parallel_for(0, str_mat.size(), grain, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const std::vector<std::string> &cells = str_mat[i];
+            std::vector<double> &row = double_mat[i];
+            row.resize(cells.size());
+            for (size_t j = 0; j < cells.size(); j++) {
+                const char *text = cells[j].data();
+                if (kernels::parse_double(text, text + cells[j].size(), row[j]))
+                    continue;
+                row[j] = std::numeric_limits<double>::quiet_NaN();
+                std::lock_guard<std::mutex> lock(mutex);
+                bad.emplace_back(i, j);
+            }
+        }
+    });
+    std::sort(bad.begin(), bad.end());
     if_double = true;
+    return bad.empty();
 }
 
-/// Method convert the elements of a Matrix from double to std::string
+/** Method convert the elements of a Matrix from double to std::string
+   Each value is written in the shortest form that parses back to it, on num_threads() threads.
+   The strings of str_mat are reused, so converting again a Matrix of the same size does not
+   allocate.
+*/
 void Matrix::to_string() {
-    std::vector<std::string> row;
-    str_mat.clear();
-    for (int i = 0; i < double_mat.size(); i++) {
-        for (int j = 0; j < double_mat[i].size(); j++)
-            row.push_back(std::to_string(double_mat[i][j]));
-        str_mat.push_back(row);
-        row.clear();
-    }
+    str_mat.resize(double_mat.size());
+    int grain = convert_rows(double_mat.empty() ? 0 : double_mat[0].size());
+    kernels::parallel_for(0, double_mat.size(), grain, [&](int begin, int end) {
+        char text[kernels::double_chars];
+        for (int i = begin; i < end; i++) {
+            const std::vector<double> &row = double_mat[i];
+            std::vector<std::string> &cells = str_mat[i];
+            cells.resize(row.size());
+            for (size_t j = 0; j < row.size(); j++)
+                cells[j].assign(text, kernels::format_double(text, row[j]));
+        }
+    });
     if_double = true;
 }
 
@@ -30,6 +30,7 @@ class Matrix {
     Matrix slice(int, int, int, int);
     Matrix T();
     void to_double();
+    bool to_double(std::vector<std::pair<int, int>> &);
     void to_string();
 
     // Overloaded Operators
@@ -0,0 +1,253 @@
+#include <matrix_kernels.hpp>
+#include <matrix_operations.hpp>
+
+#include <limits>
+
+/// Number of matrices handled by one task of the batched methods
+static const int batch_grain = 256;
+
+/// Method to return matrix b of the batch as a Matrix object
+Matrix MatrixBatch::get(int b) const {
+    if (b < 0 || b >= count)
+        assert(("Index out of range", false));
+
+    int size = rows * cols;
+    std::vector<double> buf(size);
+    for (int e = 0; e < size; e++)
+        buf[e] = data[static_cast<size_t>(e) * count + b];
+    return kernels::unpack(buf, rows, cols);
+}
+
+/// Method to return the batch as a contiguous (count, rows, cols) row-major tensor
+std::vector<double> MatrixBatch::tensor() const {
+    int size = rows * cols;
+    std::vector<double> result(data.size());
+    for (int e = 0; e < size; e++)
+        for (int b = 0; b < count; b++)
+            result[static_cast<size_t>(b) * size + e] = data[static_cast<size_t>(e) * count + b];
+    return result;
+}
+
+/** Gauss-Jordan elimination with partial pivoting on the matrices [begin, end) of a batch
+   a holds count square matrices of size n in the MatrixBatch layout and is overwritten. When b
+   is not null it holds count (n, nrhs) right-hand sides that are replaced by A^-1 * B, and a
+   matrix whose pivot is not larger than n * epsilon * max|a_ij| gets NaN solutions. When det is
+   not null, det[l] receives the determinant of matrix l. Every loop over the matrices of the
+   chunk is innermost, and the pivot row of each matrix is picked and swapped per matrix.
+*/
+static void gauss_jordan(double *a, double *b, int n, int nrhs, int count, int begin, int end,
+                         double *det) {
+    int len = end - begin;
+    const size_t stride = count;
+    auto A = [&](int i, int j) { return a + (static_cast<size_t>(i) * n + j) * stride + begin; };
+    auto B = [&](int i, int j) { return b + (static_cast<size_t>(i) * nrhs + j) * stride + begin; };
+
+    std::vector<double> tol(len, 0), best(len), pivot(len), d(len, 1), f(len);
+    std::vector<int> piv(len);
+    std::vector<char> singular(len, 0);
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++) {
+            const double *a_ij = A(i, j);
+            for (int l = 0; l < len; l++)
+                tol[l] = std::max(tol[l], std::abs(a_ij[l]));
+        }
+    for (int l = 0; l < len; l++)
+        tol[l] *= n * std::numeric_limits<double>::epsilon();
+
+    for (int k = 0; k < n; k++) {
+        const double *a_kk = A(k, k);
+        for (int l = 0; l < len; l++) {
+            best[l] = std::abs(a_kk[l]);
+            piv[l] = k;
+        }
+        for (int i = k + 1; i < n; i++) {
+            const double *a_ik = A(i, k);
+            for (int l = 0; l < len; l++) {
+                double v = std::abs(a_ik[l]);
+                piv[l] = (v > best[l]) ? i : piv[l];
+                best[l] = std::max(best[l], v);
+            }
+        }
+        for (int l = 0; l < len; l++) {
+            if (piv[l] == k)
+                continue;
+            for (int j = k; j < n; j++)
+                std::swap(A(k, j)[l], A(piv[l], j)[l]);
+            if (b)
+                for (int j = 0; j < nrhs; j++)
+                    std::swap(B(k, j)[l], B(piv[l], j)[l]);
+            d[l] = -d[l];
+        }
+
+        for (int l = 0; l < len; l++) {
+            pivot[l] = a_kk[l];
+            d[l] *= a_kk[l];
+            singular[l] = singular[l] || (best[l] <= tol[l]);
+            pivot[l] = singular[l] ? 1 : 1 / pivot[l];
+        }
+        if (b) {
+            for (int j = k + 1; j < n; j++) {
+                double *a_kj = A(k, j);
+                for (int l = 0; l < len; l++)
+                    a_kj[l] *= pivot[l];
+            }
+            for (int j = 0; j < nrhs; j++) {
+                double *b_kj = B(k, j);
+                for (int l = 0; l < len; l++)
+                    b_kj[l] *= pivot[l];
+            }
+        } else {
+            // Only the determinant is needed, so the rows below k are eliminated as in LU
+            for (int l = 0; l < len; l++)
+                pivot[l] = singular[l] ? 0 : pivot[l];
+        }
+
+        for (int i = b ? 0 : k + 1; i < n; i++) {
+            if (i == k)
+                continue;
+            const double *a_ik = A(i, k);
+            for (int l = 0; l < len; l++)
+                f[l] = b ? a_ik[l] : a_ik[l] * pivot[l];
+            for (int j = k + 1; j < n; j++) {
+                double *a_ij = A(i, j);
+                const double *a_kj = A(k, j);
+                for (int l = 0; l < len; l++)
+                    a_ij[l] -= f[l] * a_kj[l];
+            }
+            if (b)
+                for (int j = 0; j < nrhs; j++) {
+                    double *b_ij = B(i, j);
+                    const double *b_kj = B(k, j);
+                    for (int l = 0; l < len; l++)
+                        b_ij[l] -= f[l] * b_kj[l];
+                }
+        }
+    }
+
+    if (det)
+        std::copy(d.begin(), d.end(), det + begin);
+    if (b)
+        for (int l = 0; l < len; l++)
+            if (singular[l])
+                for (int e = 0; e < n * nrhs; e++)
+                    b[static_cast<size_t>(e) * stride + begin + l] =
+                        std::numeric_limits<double>::quiet_NaN();
+}
+
+/// Method to build a MatrixBatch object from a contiguous (count, rows, cols) row-major tensor
+MatrixBatch MatrixOp::batch(const std::vector<double> &tensor, int count, int rows, int cols) {
+    if (count < 0 || rows < 0 || cols < 0)
+        assert(("The dimensions must not be negative", false));
+    if (tensor.size() != static_cast<size_t>(count) * rows * cols)
+        assert(("The size of the tensor should be count * rows * cols", false));
+
+    MatrixBatch result;
+    result.count = count;
+    result.rows = rows;
+    result.cols = cols;
+    result.data.resize(tensor.size());
+    int size = rows * cols;
+    for (int b = 0; b < count; b++)
+        for (int e = 0; e < size; e++)
+            result.data[static_cast<size_t>(e) * count + b] =
+                tensor[static_cast<size_t>(b) * size + e];
+    return result;
+}
+
+/// Method to build a MatrixBatch object from Matrix objects of the same size
+MatrixBatch MatrixOp::batch(const std::vector<Matrix> &mats) {
+    int rows = mats.empty() ? 0 : mats[0].row_length();
+    int cols = mats.empty() ? 0 : mats[0].col_length();
+    std::vector<double> tensor;
+    tensor.reserve(mats.size() * rows * cols);
+    for (const Matrix &mat : mats) {
+        bool error = mat.if_double;
+        if (!error)
+            assert(("The Matrix should be first converted to double using to_double() method",
+                    error));
+        if (mat.row_length() != rows || mat.col_length() != cols)
+            assert(("The Matrix objects should be of the same dimensions", false));
+        for (const std::vector<double> &row : mat.double_mat)
+            tensor.insert(tensor.end(), row.begin(), row.end());
+    }
+    return batch(tensor, mats.size(), rows, cols);
+}
+
+/// Method to multiply each pair of matrices of two batches of the same count
+MatrixBatch MatrixOp::matmul(const MatrixBatch &A, const MatrixBatch &B) {
+    if (A.count != B.count || A.cols != B.rows)
+        assert(("The MatrixBatch objects should be of compatible dimensions", false));
+
+    MatrixBatch result;
+    result.count = A.count;
+    result.rows = A.rows;
+    result.cols = B.cols;
+    result.data.assign(static_cast<size_t>(A.rows) * B.cols * A.count, 0);
+    const size_t stride = A.count;
+    kernels::parallel_for(0, A.count, batch_grain, [&](int begin, int end) {
+        for (int i = 0; i < A.rows; i++)
+            for (int k = 0; k < A.cols; k++) {
+                const double *a_ik = A.data.data() + (static_cast<size_t>(i) * A.cols + k) * stride;
+                for (int j = 0; j < B.cols; j++) {
+                    const double *b_kj =
+                        B.data.data() + (static_cast<size_t>(k) * B.cols + j) * stride;
+                    double *c_ij =
+                        result.data.data() + (static_cast<size_t>(i) * B.cols + j) * stride;
+                    for (int l = begin; l < end; l++)
+                        c_ij[l] += a_ik[l] * b_kj[l];
+                }
+            }
+    });
+    return result;
+}
+
+/// Method to calculate the Determinant of each matrix of a batch of square matrices
+std::vector<double> MatrixOp::determinant(const MatrixBatch &A) {
+    if (A.rows != A.cols)
+        assert(("The Matrix must be a square matrix", false));
+
+    std::vector<double> a = A.data, det(A.count);
+    kernels::parallel_for(0, A.count, batch_grain, [&](int begin, int end) {
+        gauss_jordan(a.data(), nullptr, A.rows, 0, A.count, begin, end, det.data());
+    });
+    return det;
+}
+
+/** Method to calculate the Inverse of each matrix of a batch of square matrices
+   Singular matrices do not stop the batch, their inverse is filled with NaN instead.
+*/
+MatrixBatch MatrixOp::inverse(const MatrixBatch &A) {
+    if (A.rows != A.cols)
+        assert(("The Matrix must be a square matrix", false));
+
+    int n = A.rows;
+    MatrixBatch result;
+    result.count = A.count;
+    result.rows = n;
+    result.cols = n;
+    result.data.assign(A.data.size(), 0);
+    for (int i = 0; i < n; i++)
+        std::fill_n(result.data.begin() + (static_cast<size_t>(i) * n + i) * A.count, A.count, 1);
+    std::vector<double> a = A.data;
+    kernels::parallel_for(0, A.count, batch_grain, [&](int begin, int end) {
+        gauss_jordan(a.data(), result.data.data(), n, n, A.count, begin, end, nullptr);
+    });
+    return result;
+}
+
+/** Method to solve A * X = B for each pair of matrices of two batches
+   Singular matrices do not stop the batch, their solution is filled with NaN instead.
+*/
+MatrixBatch MatrixOp::solve(const MatrixBatch &A, const MatrixBatch &B) {
+    if (A.rows != A.cols)
+        assert(("The Matrix must be a square matrix", false));
+    if (A.count != B.count || B.rows != A.rows)
+        assert(("The MatrixBatch objects should be of compatible dimensions", false));
+
+    MatrixBatch result = B;
+    std::vector<double> a = A.data;
+    kernels::parallel_for(0, A.count, batch_grain, [&](int begin, int end) {
+        gauss_jordan(a.data(), result.data.data(), A.rows, B.cols, A.count, begin, end, nullptr);
+    });
+    return result;
+}
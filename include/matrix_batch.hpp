@@ -0,0 +1,23 @@
+#ifndef _matrix_batch_hpp_
+#define _matrix_batch_hpp_
+
+#include <matrix_basic.hpp>
+
+/** Batch of count small Matrix objects, all of size (rows, cols)
+   The batch is stored as a structure of arrays: element (i, j) of matrix b is
+   data[(i * cols + j) * count + b]. The batched methods loop over the matrices in their innermost
+   loop, so the compiler vectorizes across the batch and the threads split it in chunks.
+*/
+class MatrixBatch {
+  public:
+    int count = 0;
+    int rows = 0;
+    int cols = 0;
+    std::vector<double> data;
+
+    // Member functions
+    Matrix get(int) const;
+    std::vector<double> tensor() const;
+};
+
+#endif /* _matrix_batch_hpp_ */
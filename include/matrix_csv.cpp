@@ -0,0 +1,918 @@
+#include <matrix_kernels.hpp>
+#include <matrix_mmap.hpp>
+#include <matrix_operations.hpp>
+
+#include <array>
+#include <condition_variable>
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <mutex>
+#include <string_view>
+#include <thread>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+/** Finds the delimiters and newlines of a buffer 64 bytes at a time
+   Each block of 64 bytes is compared against the delimiter and '\n' with SSE2 and turned into a
+   64-bit mask, so the end of every cell that starts in the same block is found with a count of
+   trailing zeros instead of a byte by byte loop.
+*/
+class SeparatorScanner {
+  public:
+    SeparatorScanner(const char *end, char delim) : end(end), delim(delim) {}
+
+    /// Method to return the first delimiter or '\n' at or after p, or end
+    const char *next(const char *p) {
+        while (true) {
+            if (block && static_cast<size_t>(p - block) < 64) {
+                uint64_t m = mask & (~uint64_t(0) << (p - block));
+                if (m)
+                    return block + __builtin_ctzll(m);
+                p = block + 64;
+            }
+            if (p >= end)
+                return end;
+            load(p);
+        }
+    }
+
+  private:
+    const char *end;
+    char delim;
+    const char *block = nullptr;
+    uint64_t mask = 0;
+
+    void load(const char *p) {
+        block = p;
+        mask = 0;
+        if (end - p >= 64) {
+#if defined(__SSE2__)
+            const __m128i d = _mm_set1_epi8(delim), nl = _mm_set1_epi8('\n');
+            for (int k = 0; k < 4; k++) {
+                __m128i chunk = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p + 16 * k));
+                __m128i hits = _mm_or_si128(_mm_cmpeq_epi8(chunk, d), _mm_cmpeq_epi8(chunk, nl));
+                mask |= static_cast<uint64_t>(static_cast<uint16_t>(_mm_movemask_epi8(hits)))
+                        << (16 * k);
+            }
+            return;
+#endif
+        }
+        int len = std::min<ptrdiff_t>(64, end - p);
+        for (int k = 0; k < len; k++)
+            if (p[k] == delim || p[k] == '\n')
+                mask |= uint64_t(1) << k;
+        // Bytes past the end stop the scan at end
+        if (len < 64)
+            mask |= ~uint64_t(0) << len;
+    }
+};
+
+/** Method to split the first max_rows lines of [p, end) into cells
+   cell(begin, end, escaped) is called for every cell and row() after the last cell of every
+   line. Fields in double quotes may hold delimiters, newlines and "" for a quote; the quotes are
+   not part of the cell and escaped is true when the cell still holds "" pairs. A '\r' before
+   '\n' is dropped and empty lines are skipped. Returns the position after the last line read.
+*/
+template <typename Cell, typename Row>
+static const char *scan_rows(const char *p, const char *end, char delim, size_t max_rows,
+                             Cell &&cell, Row &&row) {
+    SeparatorScanner scanner(end, delim);
+    size_t rows = 0;
+    while (p < end && rows < max_rows) {
+        if (*p == '\n') {
+            p++;
+            continue;
+        }
+        if (*p == '\r' && (p + 1 == end || p[1] == '\n')) {
+            p = (p + 1 == end) ? end : p + 2;
+            continue;
+        }
+        while (true) {
+            const char *sep;
+            if (*p == '"') {
+                const char *q = p + 1;
+                bool escaped = false;
+                while (true) {
+                    q = static_cast<const char *>(std::memchr(q, '"', end - q));
+                    if (!q)
+                        assert(("The file has a quoted field that is not closed", false));
+                    if (q + 1 < end && q[1] == '"') {
+                        escaped = true;
+                        q += 2;
+                        continue;
+                    }
+                    break;
+                }
+                cell(p + 1, q, escaped);
+                sep = q + 1;
+                if (sep < end && *sep == '\r')
+                    sep++;
+                if (sep < end && *sep != delim && *sep != '\n')
+                    assert(("The file has characters after a quoted field", false));
+            } else {
+                sep = scanner.next(p);
+                const char *cell_end = sep;
+                if (cell_end > p && cell_end[-1] == '\r')
+                    cell_end--;
+                cell(p, cell_end, false);
+            }
+            if (sep < end && *sep == delim) {
+                p = sep + 1;
+                if (p < end && *p != '\n' && !(*p == '\r' && (p + 1 == end || p[1] == '\n')))
+                    continue;
+                // Trailing delimiter: the last cell of the line is empty
+                cell(p, p, false);
+                sep = (p < end && *p == '\r') ? p + 1 : p;
+            }
+            row();
+            rows++;
+            p = (sep < end) ? sep + 1 : end;
+            break;
+        }
+    }
+    return p;
+}
+
+/// Method to split all the lines of [p, end) into cells with scan_rows()
+template <typename Cell, typename Row>
+static void scan_rows(const char *p, const char *end, char delim, Cell &&cell, Row &&row) {
+    scan_rows(p, end, delim, SIZE_MAX, std::forward<Cell>(cell), std::forward<Row>(row));
+}
+
+/// Method to return the position after the first skip lines of [p, end)
+static const char *skip_lines(const char *p, const char *end, int skip) {
+    for (int i = 0; i < skip && p < end; i++) {
+        const char *nl = static_cast<const char *>(std::memchr(p, '\n', end - p));
+        p = nl ? nl + 1 : end;
+    }
+    return p;
+}
+
+/// Method to build the text of a cell, replacing the "" pairs of a quoted field by "
+static std::string cell_text(const char *begin, const char *end, bool escaped) {
+    if (!escaped)
+        return std::string(begin, end);
+    std::string text;
+    text.reserve(end - begin);
+    for (const char *c = begin; c < end; c++) {
+        text.push_back(*c);
+        if (*c == '"')
+            c++;
+    }
+    return text;
+}
+
+/** Table of the quote states of scan_rows(), to find the lines of a range without parsing it
+   A quote only opens a field at the start of the field, as in scan_rows(), so a quote inside an
+   unquoted cell is plain text. next[state][byte] is the state after byte.
+*/
+class LineStates {
+  public:
+    enum State { field_start, unquoted, quoted, quote_seen };
+    unsigned char next[4][256];
+
+    explicit LineStates(char delim) {
+        for (int c = 0; c < 256; c++) {
+            bool ends_field = (c == static_cast<unsigned char>(delim) || c == '\n');
+            next[field_start][c] = ends_field ? field_start : (c == '"') ? quoted : unquoted;
+            next[unquoted][c] = ends_field ? field_start : unquoted;
+            next[quoted][c] = (c == '"') ? quote_seen : quoted;
+            // A "" pair goes back inside the field, a '\r' waits for the '\n' of the line
+            next[quote_seen][c] = ends_field ? field_start : (c == '"') ? quoted : unquoted;
+        }
+    }
+};
+
+/** Method to return the position after the first newline of [p, end) outside quoted fields
+   state is the LineStates state at p.
+*/
+static const char *next_line(const char *p, const char *end, const LineStates &states,
+                             int state) {
+    for (; p < end; p++) {
+        if (*p == '\n' && state != LineStates::quoted)
+            return p + 1;
+        state = states.next[state][static_cast<unsigned char>(*p)];
+    }
+    return end;
+}
+
+/** Method to split the first line of [p, end) that is not empty into cells
+   Returns the position after that line, or end when there is none and cells is left empty.
+*/
+static const char *first_row(const char *p, const char *end, char delim,
+                             std::vector<std::string> &cells) {
+    LineStates states(delim);
+    while (p < end && cells.empty()) {
+        const char *line_end = next_line(p, end, states, LineStates::field_start);
+        scan_rows(
+            p, line_end, delim,
+            [&](const char *begin, const char *cell_end, bool escaped) {
+                cells.push_back(cell_text(begin, cell_end, escaped));
+            },
+            []() {});
+        p = line_end;
+    }
+    return p;
+}
+
+/// Smallest byte range a file is split into for parallel parsing
+static const size_t csv_min_range = 1 << 18;
+
+/** Method to split [p, end) into at most parts ranges of lines and return their parts + 1 bounds
+   The file is cut at even byte offsets and every cut is moved after the next newline. A newline
+   inside a quoted field does not end a line, so the state of the quote rule of scan_rows() is
+   found at every cut first: each range is run through LineStates from all four states at once,
+   in parallel, and the states at the cuts are then chained from the start of the file.
+*/
+static std::vector<const char *> split_lines(const char *p, const char *end, char delim,
+                                             int parts, int threads) {
+    size_t size = end - p;
+    parts = static_cast<int>(std::min<size_t>(parts, std::max<size_t>(size / csv_min_range, 1)));
+    std::vector<const char *> bounds(parts + 1);
+    for (int r = 0; r <= parts; r++)
+        bounds[r] = p + size * r / parts;
+    if (parts == 1)
+        return bounds;
+
+    LineStates states(delim);
+    // exits[r][s] is the state at the end of range r when it starts in state s
+    std::vector<std::array<unsigned char, 4>> exits(parts);
+    kernels::parallel_for(0, parts, 1, threads, [&](int begin, int stop) {
+        for (int r = begin; r < stop; r++) {
+            unsigned char s0 = 0, s1 = 1, s2 = 2, s3 = 3;
+            for (const char *q = bounds[r]; q < bounds[r + 1]; q++) {
+                unsigned char c = *q;
+                s0 = states.next[s0][c];
+                s1 = states.next[s1][c];
+                s2 = states.next[s2][c];
+                s3 = states.next[s3][c];
+            }
+            exits[r] = {s0, s1, s2, s3};
+        }
+    });
+    std::vector<int> entry(parts, LineStates::field_start);
+    for (int r = 1; r < parts; r++)
+        entry[r] = exits[r - 1][entry[r - 1]];
+
+    kernels::parallel_for(1, parts, 1, threads, [&](int begin, int stop) {
+        for (int r = begin; r < stop; r++)
+            bounds[r] = next_line(bounds[r], end, states, entry[r]);
+    });
+    // A line longer than a range pushes the next cuts over the same newline
+    for (int r = 1; r < parts; r++)
+        bounds[r] = std::max(bounds[r], bounds[r - 1]);
+    return bounds;
+}
+
+/** Method to parse the lines of [p, end) on threads threads and return one slab per range
+   Every range of split_lines() is parsed by parse(begin, end, slab) on its own, so the slabs
+   come back in file order whichever thread parsed them.
+*/
+template <typename Slab, typename Parse>
+static std::vector<Slab> parse_ranges(const char *p, const char *end, char delim, int threads,
+                                      Parse &&parse) {
+    threads = std::max(threads, 1);
+    std::vector<const char *> bounds =
+        split_lines(p, end, delim, threads > 1 ? 4 * threads : 1, threads);
+    std::vector<Slab> slabs(bounds.size() - 1);
+    kernels::parallel_for(0, slabs.size(), 1, threads, [&](int begin, int stop) {
+        for (int r = begin; r < stop; r++)
+            parse(bounds[r], bounds[r + 1], slabs[r]);
+    });
+    return slabs;
+}
+
+/** Method to read a csv file and return a Matrix object of strings
+   The file is memory-mapped, split in ranges of lines parsed in parallel on the threads set with
+   set_num_threads(), and each cell is copied once into its string. Cells are split as in
+   scan_rows(), so unlike the std::getline reader this replaced, quotes are removed, blank lines
+   are skipped and "3," is two cells. A file that cannot be opened stops the program.
+*/
+Matrix MatrixOp::genfromtxt(std::string filename, char delim) {
+    MappedFile file(filename, true);
+    typedef std::vector<std::vector<std::string>> Slab;
+    std::vector<Slab> slabs = parse_ranges<Slab>(
+        file.data, file.data + file.size, delim, kernels::num_threads(),
+        [&](const char *p, const char *end, Slab &slab) {
+            std::vector<std::string> cells;
+            scan_rows(
+                p, end, delim,
+                [&](const char *begin, const char *cell_end, bool escaped) {
+                    cells.push_back(cell_text(begin, cell_end, escaped));
+                },
+                [&]() {
+                    size_t width = cells.size();
+                    slab.push_back(std::move(cells));
+                    cells.clear();
+                    cells.reserve(width);
+                });
+        });
+
+    Matrix mat;
+    size_t rows = 0;
+    for (const Slab &slab : slabs)
+        rows += slab.size();
+    mat.str_mat.reserve(rows);
+    for (Slab &slab : slabs)
+        std::move(slab.begin(), slab.end(), std::back_inserter(mat.str_mat));
+    return mat;
+}
+
+/// Operators of CsvFilter, in the order of their codes
+static const std::vector<std::string> filter_ops = {"==", "!=", "<", "<=", ">", ">="};
+
+/// Method to compare a with b using the operator of code op
+template <typename T> static bool compare(const T &a, int op, const T &b) {
+    switch (op) {
+    case 0:
+        return a == b;
+    case 1:
+        return a != b;
+    case 2:
+        return a < b;
+    case 3:
+        return a <= b;
+    case 4:
+        return a > b;
+    default:
+        return a >= b;
+    }
+}
+
+/// Method to tell if the cell [begin, end) is one of the missing tokens
+static bool is_missing(const char *begin, const char *end, bool escaped,
+                       const std::vector<std::string> &missing) {
+    if (escaped)
+        return std::find(missing.begin(), missing.end(), cell_text(begin, end, true)) !=
+               missing.end();
+    std::string_view text(begin, end - begin);
+    for (const std::string &token : missing)
+        if (text == token)
+            return true;
+    return false;
+}
+
+/** Method to parse the lines of [p, end) into the kept columns of table
+   usecols lists the columns of the file to keep, in order, and numeric tells which of them are
+   parsed into table.data; the others are appended to table.strings. Every line must have width
+   cells. The double columns keep their text as the string values of table.data. Cells of the
+   columns that are not kept are only scanned, and a line is dropped as soon as one of the
+   filters fails, so the rest of its cells are not converted and it is never stored. A double
+   cell that does not parse is checked against the missing tokens only then, so clean cells pay
+   nothing for them; a missing cell becomes NaN with the text "nan" and is cleared in the
+   validity mask when the options ask for it.
+*/
+static void parse_table(const char *p, const char *end, int width, const std::vector<int> &usecols,
+                        const std::vector<bool> &numeric, const CsvOptions &options, int threads,
+                        CsvTable &table) {
+    char delim = options.delim;
+    const std::vector<std::string> &missing = options.missing;
+    // slot[c] is the index of file column c among the double or string columns, -1 if dropped
+    std::vector<int> slot(width, -1);
+    std::vector<char> is_double(width, 0);
+    int doubles = 0, strings = 0;
+    for (size_t k = 0; k < usecols.size(); k++) {
+        int c = usecols[k];
+        if (slot[c] != -1)
+            assert(("A column should only be used once", false));
+        is_double[c] = numeric[k];
+        slot[c] = numeric[k] ? doubles++ : strings++;
+    }
+
+    // The constant of a filter is compared as a number when it is one, as a string otherwise
+    struct Test {
+        int col;
+        int op;
+        bool numeric;
+        double number;
+        std::string text;
+    };
+    std::vector<Test> tests;
+    std::vector<char> tested(width, 0);
+    for (const CsvFilter &filter : options.filters) {
+        if (filter.col < 0 || filter.col >= width)
+            assert(("Index out of range", false));
+        int op = std::find(filter_ops.begin(), filter_ops.end(), filter.op) - filter_ops.begin();
+        if (op == static_cast<int>(filter_ops.size()))
+            assert(("The operator should be one of ==, !=, <, <=, > or >=", false));
+        Test test = {filter.col, op, false, 0, filter.value};
+        const char *value = filter.value.data();
+        test.numeric = kernels::parse_double(value, value + filter.value.size(), test.number);
+        tests.push_back(test);
+        tested[filter.col] = 1;
+    }
+
+    // gaps holds the (row in the slab, slot) positions of the missing cells, which are rare
+    struct Slab {
+        std::vector<std::vector<double>> values;
+        std::vector<std::vector<std::string>> cells;
+        std::vector<std::vector<std::string>> strings;
+        std::vector<std::pair<size_t, int>> gaps;
+    };
+    std::vector<Slab> slabs = parse_ranges<Slab>(
+        p, end, delim, threads, [&](const char *range_begin, const char *range_end, Slab &slab) {
+            std::vector<double> values(doubles);
+            std::vector<std::string> cells(doubles), texts(strings);
+            slab.strings.resize(strings);
+            int col = 0;
+            bool rejected = false;
+            scan_rows(
+                range_begin, range_end, delim,
+                [&](const char *begin, const char *cell_end, bool escaped) {
+                    if (col >= width)
+                        assert(("All the rows should have the same number of columns", false));
+                    if (rejected) {
+                        col++;
+                        return;
+                    }
+                    if (tested[col])
+                        for (const Test &test : tests) {
+                            if (test.col != col)
+                                continue;
+                            double value;
+                            if (test.numeric)
+                                rejected = !kernels::parse_double(begin, cell_end, value) ||
+                                           !compare(value, test.op, test.number);
+                            else if (!escaped)
+                                rejected = !compare(std::string_view(begin, cell_end - begin),
+                                                    test.op, std::string_view(test.text));
+                            else
+                                rejected = !compare(cell_text(begin, cell_end, escaped), test.op,
+                                                    test.text);
+                            if (rejected) {
+                                col++;
+                                return;
+                            }
+                        }
+                    int s = slot[col];
+                    if (s >= 0 && is_double[col]) {
+                        if (kernels::parse_double(begin, cell_end, values[s])) {
+                            cells[s] = cell_text(begin, cell_end, escaped);
+                        } else if (is_missing(begin, cell_end, escaped, missing)) {
+                            values[s] = std::numeric_limits<double>::quiet_NaN();
+                            cells[s] = "nan";
+                            slab.gaps.emplace_back(slab.values.size(), s);
+                        } else {
+                            assert(("The file contains a value that is not a number", false));
+                        }
+                    } else if (s >= 0) {
+                        texts[s] = cell_text(begin, cell_end, escaped);
+                    }
+                    col++;
+                },
+                [&]() {
+                    if (col != width)
+                        assert(("All the rows should have the same number of columns", false));
+                    col = 0;
+                    if (rejected) {
+                        // Cells before the failed filter may already have been found missing
+                        while (!slab.gaps.empty() && slab.gaps.back().first == slab.values.size())
+                            slab.gaps.pop_back();
+                        rejected = false;
+                        return;
+                    }
+                    slab.values.push_back(std::move(values));
+                    slab.cells.push_back(std::move(cells));
+                    for (int s = 0; s < strings; s++)
+                        slab.strings[s].push_back(std::move(texts[s]));
+                    values = std::vector<double>(doubles);
+                    cells = std::vector<std::string>(doubles);
+                });
+        });
+
+    size_t rows = 0;
+    for (const Slab &slab : slabs)
+        rows += slab.values.size();
+    Matrix &mat = table.data;
+    mat.double_mat.reserve(rows);
+    mat.str_mat.reserve(rows);
+    table.strings.assign(strings, std::vector<std::string>());
+    for (std::vector<std::string> &column : table.strings)
+        column.reserve(rows);
+    if (options.mask) {
+        // Every bit of the mask is set, except the padding after the last value
+        size_t bits = rows * doubles;
+        table.valid.assign((bits + 63) / 64, ~uint64_t(0));
+        if (bits % 64)
+            table.valid.back() = (uint64_t(1) << (bits % 64)) - 1;
+    }
+    for (Slab &slab : slabs) {
+        size_t first = mat.double_mat.size();
+        if (options.mask)
+            for (const std::pair<size_t, int> &gap : slab.gaps) {
+                size_t bit = (first + gap.first) * doubles + gap.second;
+                table.valid[bit / 64] &= ~(uint64_t(1) << (bit % 64));
+            }
+        std::move(slab.values.begin(), slab.values.end(), std::back_inserter(mat.double_mat));
+        std::move(slab.cells.begin(), slab.cells.end(), std::back_inserter(mat.str_mat));
+        for (int s = 0; s < strings; s++)
+            std::move(slab.strings[s].begin(), slab.strings[s].end(),
+                      std::back_inserter(table.strings[s]));
+    }
+    mat.if_double = true;
+}
+
+/// Method to read a numeric csv file into a Matrix object of doubles on num_threads() threads
+Matrix MatrixOp::genfromtxt(std::string filename, char delim, int skip_header) {
+    return genfromtxt(filename, delim, skip_header, kernels::num_threads());
+}
+
+/** Method to read a numeric csv file straight into a Matrix object of doubles
+   The first skip_header lines are skipped and the rest of the file is split in ranges of lines
+   parsed on threads threads. Every cell is parsed with std::from_chars while the file is scanned,
+   and keeps its text as the string value, so the result is the same as genfromtxt() followed by
+   to_double() without a second pass over the strings.
+*/
+Matrix MatrixOp::genfromtxt(std::string filename, char delim, int skip_header, int threads) {
+    MappedFile file(filename, true);
+    const char *end = file.data + file.size;
+    const char *p = skip_lines(file.data, end, skip_header);
+    std::vector<std::string> first;
+    first_row(p, end, delim, first);
+    int width = first.size();
+    std::vector<int> usecols(width);
+    for (int c = 0; c < width; c++)
+        usecols[c] = c;
+
+    CsvOptions options;
+    options.delim = delim;
+    CsvTable table;
+    parse_table(p, end, width, usecols, std::vector<bool>(width, true), options, threads, table);
+    return std::move(table.data);
+}
+
+/** Method to read a csv file with named and typed columns into a CsvTable object
+   The header and the kept columns are set with CsvOptions. Columns without a dtype are "double"
+   when every cell of the first sample_rows rows is a number or a missing token and "string"
+   otherwise, and a later cell of a "double" column that is neither is an error. The file is
+   then parsed once, in parallel, with the double columns going straight into the data Matrix
+   and the rows that fail one of the filters left out while parsing.
+*/
+CsvTable MatrixOp::genfromtxt(std::string filename, const CsvOptions &options) {
+    MappedFile file(filename, true);
+    const char *end = file.data + file.size;
+    const char *p = skip_lines(file.data, end, options.skip_header);
+    char delim = options.delim;
+
+    std::vector<std::string> header;
+    if (options.names)
+        p = first_row(p, end, delim, header);
+    std::vector<std::string> first;
+    first_row(p, end, delim, first);
+    int width = options.names ? header.size() : first.size();
+
+    std::vector<int> usecols = options.usecols;
+    if (usecols.empty())
+        for (int c = 0; c < width; c++)
+            usecols.push_back(c);
+    for (int c : usecols)
+        if (c < 0 || c >= width)
+            assert(("Index out of range", false));
+    int kept = usecols.size();
+    if (!options.dtypes.empty() && static_cast<int>(options.dtypes.size()) != kept)
+        assert(("There should be one dtype per used column", false));
+
+    CsvTable table;
+    table.dtypes = options.dtypes;
+    table.dtypes.resize(kept);
+    for (const std::string &dtype : table.dtypes)
+        if (dtype != "" && dtype != "double" && dtype != "string")
+            assert(("The dtype should be \"double\", \"string\" or \"\"", false));
+
+    // Infer the missing dtypes from the first sample_rows rows
+    std::vector<char> numeric(width, 1), kept_col(width, 0);
+    for (int c : usecols)
+        kept_col[c] = 1;
+    LineStates line_states(delim);
+    const char *sample_end = p;
+    for (int i = 0; i < options.sample_rows && sample_end < end; i++)
+        sample_end = next_line(sample_end, end, line_states, LineStates::field_start);
+    int col = 0;
+    scan_rows(
+        p, sample_end, delim,
+        [&](const char *begin, const char *cell_end, bool escaped) {
+            double value;
+            if (col < width && kept_col[col] && !kernels::parse_double(begin, cell_end, value) &&
+                !is_missing(begin, cell_end, escaped, options.missing))
+                numeric[col] = 0;
+            col++;
+        },
+        [&]() { col = 0; });
+    std::vector<bool> is_double(kept);
+    for (int k = 0; k < kept; k++) {
+        if (table.dtypes[k] == "")
+            table.dtypes[k] = numeric[usecols[k]] ? "double" : "string";
+        is_double[k] = (table.dtypes[k] == "double");
+        table.names.push_back(options.names ? header[usecols[k]] : std::to_string(usecols[k]));
+    }
+
+    int threads = (options.threads > 0) ? options.threads : kernels::num_threads();
+    parse_table(p, end, width, usecols, is_double, options, threads, table);
+    return table;
+}
+
+/** Method to return the column called name as a (rows, 1) Matrix object
+   A "double" column is returned as doubles and a "string" column as strings.
+*/
+Matrix CsvTable::column(std::string name) const {
+    int k = std::find(names.begin(), names.end(), name) - names.begin();
+    if (k == static_cast<int>(names.size()))
+        assert(("There is no column with this name", false));
+    int slot = std::count(dtypes.begin(), dtypes.begin() + k, dtypes[k]);
+
+    Matrix mat;
+    if (dtypes[k] == "string") {
+        for (const std::string &value : strings[slot])
+            mat.str_mat.push_back({value});
+        return mat;
+    }
+    for (size_t i = 0; i < data.double_mat.size(); i++) {
+        mat.double_mat.push_back({data.double_mat[i][slot]});
+        mat.str_mat.push_back({data.str_mat[i][slot]});
+    }
+    mat.if_double = true;
+    return mat;
+}
+
+/** Method to tell if value (row, col) of data was read from the file rather than missing
+   Without a validity mask, a value is valid when it is not NaN.
+*/
+bool CsvTable::is_valid(int row, int col) const {
+    if (row < 0 || row >= data.row_length() || col < 0 || col >= data.col_length())
+        assert(("Index out of range", false));
+    if (valid.empty())
+        return !std::isnan(data.double_mat[row][col]);
+    size_t bit = static_cast<size_t>(row) * data.col_length() + col;
+    return (valid[bit / 64] >> (bit % 64)) & 1;
+}
+
+/** Method to read a numeric delimited file straight into a SparseMatrix object
+   The first skip_header lines are skipped. Values are parsed as they are read and only the
+   non-zero ones are kept, so the dense Matrix is never formed.
+*/
+SparseMatrix MatrixOp::genfromtxt_sparse(std::string filename, char delim, int skip_header) {
+    MappedFile file(filename, true);
+    const char *end = file.data + file.size;
+    SparseMatrix result;
+    result.cols = -1;
+    int col = 0;
+    scan_rows(
+        skip_lines(file.data, end, skip_header), end, delim,
+        [&](const char *begin, const char *cell_end, bool) {
+            double value;
+            if (!kernels::parse_double(begin, cell_end, value))
+                assert(("The file contains a value that is not a number", false));
+            if (value != 0) {
+                result.indices.push_back(col);
+                result.data.push_back(value);
+            }
+            col++;
+        },
+        [&]() {
+            if (result.cols == -1)
+                result.cols = col;
+            else if (result.cols != col)
+                assert(("All the rows should have the same number of columns", false));
+            result.indptr.push_back(result.indices.size());
+            result.rows++;
+            col = 0;
+        });
+    result.cols = std::max(result.cols, 0);
+    return result;
+}
+
+/// Number of rows formatted by one task of savetxt()
+static const int savetxt_grain = 4096;
+
+/// Method to append a cell of text, quoted when it holds the delimiter, a quote or a newline
+static void append_cell(std::string &out, const std::string &text, char delim) {
+    const char special[] = {delim, '"', '\n', '\r', '\0'};
+    if (text.find_first_of(special) == std::string::npos) {
+        out += text;
+        return;
+    }
+    out += '"';
+    for (char c : text) {
+        if (c == '"')
+            out += '"';
+        out += c;
+    }
+    out += '"';
+}
+
+/** Method to format the rows [begin, end) of a Matrix object as lines of text into out
+   Doubles are written with kernels::format_double() straight into out, strings with append_cell().
+*/
+static void format_rows(const Matrix &mat, int begin, int end, char delim, std::string &out) {
+    out.clear();
+    size_t pos = 0;
+    for (int i = begin; i < end; i++) {
+        if (!mat.if_double) {
+            const std::vector<std::string> &row = mat.str_mat[i];
+            for (size_t j = 0; j < row.size(); j++) {
+                if (j)
+                    out += delim;
+                append_cell(out, row[j], delim);
+            }
+            out += '\n';
+            continue;
+        }
+        const std::vector<double> &row = mat.double_mat[i];
+        size_t need = pos + row.size() * (kernels::double_chars + 1) + 1;
+        if (out.size() < need)
+            out.resize(std::max(need, 2 * out.size()));
+        char *p = &out[pos];
+        for (size_t j = 0; j < row.size(); j++) {
+            if (j)
+                *p++ = delim;
+            p = kernels::format_double(p, row[j]);
+        }
+        *p++ = '\n';
+        pos = p - out.data();
+    }
+    if (mat.if_double)
+        out.resize(pos);
+}
+
+/** Method to write a Matrix object to a delimited text file
+   header is written as the first line unless it is empty. Doubles are written in the shortest
+   form that std::from_chars reads back to the same value, so genfromtxt() with skip_header 1
+   returns the exact Matrix, and strings are quoted when they hold the delimiter, a quote or a
+   newline. Blocks of rows are formatted into separate buffers on num_threads() threads and the
+   buffers are then written in order, one write per block.
+*/
+void MatrixOp::savetxt(const Matrix &mat, std::string filename, char delim, std::string header) {
+    int rows = mat.if_double ? mat.double_mat.size() : mat.str_mat.size();
+    size_t cols = 0;
+    for (int i = 0; i < rows; i++) {
+        size_t width = mat.if_double ? mat.double_mat[i].size() : mat.str_mat[i].size();
+        if (i && width != cols)
+            assert(("All the rows should have the same number of columns", false));
+        cols = width;
+    }
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        assert(("The file could not be opened", false));
+    if (!header.empty())
+        file << header << '\n';
+
+    // A few blocks per thread are formatted at once, so the buffers stay a bounded size
+    int blocks = 4 * kernels::num_threads();
+    std::vector<std::string> buffers(blocks);
+    int step = blocks * savetxt_grain;
+    for (int start = 0, stop = 0; start < rows; start = stop) {
+        stop = rows - start > step ? start + step : rows;
+        int count = (stop - start + savetxt_grain - 1) / savetxt_grain;
+        kernels::parallel_for(0, count, 1, [&](int begin, int end) {
+            for (int b = begin; b < end; b++) {
+                int first = start + b * savetxt_grain;
+                format_rows(mat, first, std::min(stop, first + savetxt_grain), delim, buffers[b]);
+            }
+        });
+        for (int b = 0; b < count; b++)
+            file.write(buffers[b].data(), buffers[b].size());
+    }
+    if (!file)
+        assert(("The file could not be written", false));
+}
+
+/** State of a CsvChunkReader shared with its background thread
+   The worker parses the next chunk into ready while the consumer holds the previous one. full
+   tells that ready holds a chunk that was not taken yet, done that the file is over.
+*/
+class CsvChunkState {
+  public:
+    MappedFile file;
+    char delim;
+    int rows;
+    int width = -1;
+    const char *p;
+    const char *end;
+
+    Matrix ready;
+    bool full = false;
+    bool done = false;
+    bool stop = false;
+    std::mutex mutex;
+    std::condition_variable cv;
+    std::thread worker;
+
+    CsvChunkState(const std::string &filename, char delim, int skip_header, int rows)
+        : file(filename, true), delim(delim), rows(rows) {
+        end = file.data + file.size;
+        p = skip_lines(file.data, end, skip_header);
+    }
+
+    int fill();
+    void run();
+};
+
+/** Method to parse the next rows lines into ready and return how many were read
+   The rows of ready are overwritten in place, so their vectors and strings keep their storage
+   from one chunk to the next.
+*/
+int CsvChunkState::fill() {
+    std::vector<std::vector<double>> &values = ready.double_mat;
+    std::vector<std::vector<std::string>> &cells = ready.str_mat;
+    int r = 0;
+    size_t c = 0;
+    file.release(p);
+    p = scan_rows(
+        p, end, delim, rows,
+        [&](const char *begin, const char *cell_end, bool escaped) {
+            if (c == 0 && static_cast<int>(values.size()) == r) {
+                values.emplace_back();
+                cells.emplace_back();
+            }
+            double value;
+            if (!kernels::parse_double(begin, cell_end, value))
+                assert(("The file contains a value that is not a number", false));
+            if (c < values[r].size()) {
+                values[r][c] = value;
+            } else {
+                values[r].push_back(value);
+                cells[r].emplace_back();
+            }
+            if (escaped)
+                cells[r][c] = cell_text(begin, cell_end, escaped);
+            else
+                cells[r][c].assign(begin, cell_end);
+            c++;
+        },
+        [&]() {
+            if (width == -1)
+                width = c;
+            else if (static_cast<int>(c) != width)
+                assert(("All the rows should have the same number of columns", false));
+            values[r].resize(c);
+            cells[r].resize(c);
+            c = 0;
+            r++;
+        });
+    values.resize(r);
+    cells.resize(r);
+    return r;
+}
+
+/// Method run by the background thread: parse a chunk whenever the previous one was taken
+void CsvChunkState::run() {
+    while (true) {
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            cv.wait(lock, [&] { return !full || stop; });
+            if (stop)
+                return;
+        }
+        int count = fill();
+        std::unique_lock<std::mutex> lock(mutex);
+        full = count > 0;
+        done = (p >= end);
+        cv.notify_all();
+        if (done)
+            return;
+    }
+}
+
+/** Constructor of a CsvChunkReader
+   Reads the numeric file filename, delimited by delim, in chunks of rows lines after skipping
+   the first skip_header lines. The first chunk starts to be parsed right away.
+*/
+CsvChunkReader::CsvChunkReader(std::string filename, char delim, int skip_header, int rows) {
+    if (rows <= 0)
+        assert(("The number of rows of a chunk should be positive", false));
+    state.reset(new CsvChunkState(filename, delim, skip_header, rows));
+    state->ready.if_double = true;
+    state->worker = std::thread([this] { state->run(); });
+}
+
+CsvChunkReader::~CsvChunkReader() {
+    {
+        std::unique_lock<std::mutex> lock(state->mutex);
+        state->stop = true;
+    }
+    state->cv.notify_all();
+    state->worker.join();
+}
+
+/** Method to move the next chunk of the file into chunk
+   The previous rows of chunk are handed to the background thread to hold the chunk after this
+   one. Returns false, and leaves chunk as it is, when there are no rows left.
+*/
+bool CsvChunkReader::next(Matrix &chunk) {
+    std::unique_lock<std::mutex> lock(state->mutex);
+    state->cv.wait(lock, [&] { return state->full || state->done; });
+    if (!state->full)
+        return false;
+    std::swap(chunk.double_mat, state->ready.double_mat);
+    std::swap(chunk.str_mat, state->ready.str_mat);
+    chunk.if_double = true;
+    state->full = false;
+    state->cv.notify_all();
+    return true;
+}
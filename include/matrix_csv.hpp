@@ -0,0 +1,87 @@
+#ifndef _matrix_csv_hpp_
+#define _matrix_csv_hpp_
+
+#include <matrix_basic.hpp>
+
+#include <cstdint>
+#include <memory>
+
+/** Row filter of CsvOptions: keeps the rows where column col compares to value with op
+   col is a column of the file, kept or not, and op is one of "==", "!=", "<", "<=", ">" or ">=".
+   When value is a number the cells are compared as numbers and a cell that is not a number fails
+   the filter, otherwise the cells are compared as strings.
+*/
+class CsvFilter {
+  public:
+    int col = 0;
+    std::string op = "==";
+    std::string value;
+};
+
+/** Options of MatrixOp::genfromtxt() for files with named and typed columns
+   skip_header lines are skipped first, then the next line holds the column names when names is
+   true. usecols lists the columns to keep, in the order they are wanted, and keeps them all when
+   empty. dtypes gives the type of each kept column, "double", "string" or "" to infer it from the
+   first sample_rows rows, and infers them all when empty. Only the rows that pass all the
+   filters are kept. A cell of a "double" column that is one of the missing tokens, such as ""
+   or "NA", is read as NaN, and mask asks for the validity mask of CsvTable to be filled.
+   threads is the number of threads used to parse the file, 0 for the number set with
+   set_num_threads().
+*/
+class CsvOptions {
+  public:
+    char delim = ',';
+    int skip_header = 0;
+    bool names = false;
+    std::vector<int> usecols;
+    std::vector<std::string> dtypes;
+    std::vector<CsvFilter> filters;
+    std::vector<std::string> missing;
+    bool mask = false;
+    int sample_rows = 100;
+    int threads = 0;
+};
+
+/** Columns read by MatrixOp::genfromtxt() with CsvOptions
+   names and dtypes describe the kept columns in order. The "double" columns are parsed straight
+   into data, a Matrix object of doubles, and the "string" columns are stored one vector per
+   column in strings, both in the order of the kept columns. When CsvOptions::mask is set, bit
+   i * cols + j of valid, with cols the number of columns of data, is 0 when value (i, j) of
+   data was a missing token and 1 otherwise.
+*/
+class CsvTable {
+  public:
+    std::vector<std::string> names;
+    std::vector<std::string> dtypes;
+    Matrix data;
+    std::vector<std::vector<std::string>> strings;
+    std::vector<uint64_t> valid;
+
+    // Member functions
+    Matrix column(std::string) const;
+    bool is_valid(int, int) const;
+};
+
+class CsvChunkState;
+
+/** Reader of a numeric csv file in chunks of rows, for files larger than memory
+   Each call to next() fills a Matrix object of doubles with the next rows of the file and
+   returns false once the file is over. The next chunk is parsed on a background thread while
+   the current one is used, and the two chunks trade their buffers, so the rows of a chunk are
+   allocated once and reused for the whole file.
+*/
+class CsvChunkReader {
+  public:
+    CsvChunkReader(std::string, char, int, int);
+    ~CsvChunkReader();
+    CsvChunkReader(const CsvChunkReader &) = delete;
+    CsvChunkReader &operator=(const CsvChunkReader &) = delete;
+
+    // Member functions
+    bool next(Matrix &);
+
+  private:
+    std::unique_ptr<CsvChunkState> state;
+};
+
+#endif /* _matrix_csv_hpp_ */
@@ -0,0 +1,620 @@
+#include <matrix_kernels.hpp>
+#include <matrix_mmap.hpp>
+#include <matrix_operations.hpp>
+
+#include <cstring>
+#include <limits>
+
+#if defined(_WIN32)
+#define MATRIX_NO_MMAP
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+MappedFile::MappedFile(const std::string &filename, bool sequential) {
+#if defined(MATRIX_NO_MMAP)
+    std::ifstream file(filename, std::ios::binary);
+    if (!file)
+        assert(("The file could not be opened", false));
+    buffer.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    data = buffer.data();
+    size = buffer.size();
+#else
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd < 0)
+        assert(("The file could not be opened", false));
+    struct stat info;
+    if (::fstat(fd, &info) == 0 && info.st_size > 0) {
+        size = info.st_size;
+        map = ::mmap(nullptr, size, PROT_READ, MAP_PRIVATE, fd, 0);
+        if (map == MAP_FAILED) {
+            // e.g. a pipe or a special file, fall back to reading it
+            map = nullptr;
+            buffer.resize(size);
+            size = ::pread(fd, buffer.data(), size, 0);
+            data = buffer.data();
+        } else {
+            if (sequential)
+                ::madvise(map, size, MADV_SEQUENTIAL);
+            data = static_cast<const char *>(map);
+        }
+    }
+    ::close(fd);
+#endif
+}
+
+MappedFile::~MappedFile() {
+#if !defined(MATRIX_NO_MMAP)
+    if (map)
+        ::munmap(map, size);
+#endif
+}
+
+/** Method to give the pages of the file before upto back to the kernel
+   Used when a file is read once from start to end, so that the resident memory stays bounded by
+   what has not been consumed yet. The pages are read again if they are used after all.
+*/
+void MappedFile::release(const char *upto) {
+#if !defined(MATRIX_NO_MMAP)
+    if (!map)
+        return;
+    size_t page = ::sysconf(_SC_PAGESIZE);
+    size_t len = (upto - data) / page * page;
+    if (len > released) {
+        ::madvise(static_cast<char *>(map) + released, len - released, MADV_DONTNEED);
+        released = len;
+    }
+#endif
+}
+
+/** Header at the start of a binary Matrix file
+   The values follow at offset, a multiple of 64, as rows * cols row-major doubles in the byte
+   order of the machine that saved them. endian holds 0x01020304 in that byte order, so a file
+   saved on a machine of the other byte order is recognized and swapped when loaded.
+*/
+struct BinaryHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t endian;
+    uint32_t dtype;
+    uint32_t reserved;
+    uint64_t rows;
+    uint64_t cols;
+    uint64_t offset;
+    uint64_t checksum;
+};
+
+static const char binary_magic[8] = {'M', 'A', 'T', 'R', 'I', 'X', 'B', '\0'};
+static const uint32_t binary_version = 1;
+static const uint32_t binary_endian = 0x01020304;
+/// dtype of a file of doubles, the only one written so far
+static const uint32_t binary_float64 = 1;
+static const uint64_t binary_offset = 64;
+
+/** Checksum of a sequence of doubles, fed one run of values after the other
+   Four interleaved multiply-xorshift lanes, so that hashing is not bound by the latency of one
+   multiplication and runs at memory speed.
+*/
+class Checksum {
+  public:
+    void add(const double *values, size_t n) {
+        for (size_t i = 0; i < n; i++, count++) {
+            uint64_t word;
+            std::memcpy(&word, values + i, sizeof(word));
+            uint64_t &h = lane[count & 3];
+            h = (h ^ word) * 0x9e3779b97f4a7c15ULL;
+            h ^= h >> 32;
+        }
+    }
+
+    uint64_t value() const {
+        uint64_t h = count;
+        for (uint64_t l : lane) {
+            h = (h ^ l) * 0xff51afd7ed558ccdULL;
+            h ^= h >> 33;
+        }
+        return h;
+    }
+
+  private:
+    uint64_t lane[4] = {1, 2, 3, 4};
+    uint64_t count = 0;
+};
+
+/// Method to get value (i, j) of the view
+double MatrixView::get(int i, int j) const {
+    if (i < 0 || i >= rows || j < 0 || j >= cols)
+        assert(("Index out of range", false));
+    return data[static_cast<size_t>(i) * cols + j];
+}
+
+/// Method to copy the view into a Matrix object of doubles
+Matrix MatrixView::to_matrix() const {
+    return kernels::unpack(std::vector<double>(data, data + static_cast<size_t>(rows) * cols),
+                           rows, cols);
+}
+
+/// Method to read all the values of the view and compare their checksum with the stored one, if any
+bool MatrixView::verify() const {
+    if (!has_checksum)
+        return true;
+    Checksum sum;
+    sum.add(data, static_cast<size_t>(rows) * cols);
+    return sum.value() == checksum;
+}
+
+/** Method to save a Matrix object of doubles to a binary file
+   The file holds a BinaryHeader padded to 64 bytes followed by the raw row-major values, so
+   load() can map it without parsing anything.
+*/
+void MatrixOp::save(const Matrix &mat, std::string filename) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    BinaryHeader header = {};
+    std::memcpy(header.magic, binary_magic, sizeof(binary_magic));
+    header.version = binary_version;
+    header.endian = binary_endian;
+    header.dtype = binary_float64;
+    header.rows = mat.double_mat.size();
+    header.cols = header.rows ? mat.double_mat[0].size() : 0;
+    header.offset = binary_offset;
+    Checksum sum;
+    for (const std::vector<double> &row : mat.double_mat) {
+        if (row.size() != header.cols)
+            assert(("All the rows should have the same number of columns", false));
+        sum.add(row.data(), row.size());
+    }
+    header.checksum = sum.value();
+
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        assert(("The file could not be opened", false));
+    char padding[binary_offset] = {};
+    std::memcpy(padding, &header, sizeof(header));
+    file.write(padding, binary_offset);
+    for (const std::vector<double> &row : mat.double_mat)
+        file.write(reinterpret_cast<const char *>(row.data()), row.size() * sizeof(double));
+    if (!file)
+        assert(("The file could not be written", false));
+}
+
+/// Method to reverse the byte order of a 4 or 8 byte value
+template <typename T> static T byteswap(T value) {
+    char bytes[sizeof(T)];
+    std::memcpy(bytes, &value, sizeof(T));
+    std::reverse(bytes, bytes + sizeof(T));
+    std::memcpy(&value, bytes, sizeof(T));
+    return value;
+}
+
+/** Method to open a binary file written by save() as a read-only MatrixView object
+   The file is memory-mapped and only its header is read, so this takes the same time whatever the
+   size of the Matrix; the values are read by the kernel when they are first used. A file saved
+   on a machine of the other byte order is copied with its bytes swapped instead.
+*/
+MatrixView MatrixOp::load(std::string filename) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(filename, false);
+    BinaryHeader header;
+    if (file->size < binary_offset)
+        assert(("The file is not a binary Matrix file", false));
+    std::memcpy(&header, file->data, sizeof(header));
+    if (std::memcmp(header.magic, binary_magic, sizeof(binary_magic)) != 0)
+        assert(("The file is not a binary Matrix file", false));
+
+    bool swapped = (header.endian == byteswap(binary_endian));
+    if (swapped) {
+        header.version = byteswap(header.version);
+        header.dtype = byteswap(header.dtype);
+        header.rows = byteswap(header.rows);
+        header.cols = byteswap(header.cols);
+        header.offset = byteswap(header.offset);
+        header.checksum = byteswap(header.checksum);
+    } else if (header.endian != binary_endian) {
+        assert(("The file is not a binary Matrix file", false));
+    }
+    if (header.version != binary_version)
+        assert(("The binary Matrix file was written by a newer version", false));
+    if (header.dtype != binary_float64)
+        assert(("The binary Matrix file holds an unknown dtype", false));
+    // rows and cols are checked before they are multiplied, so count and its size cannot overflow
+    if (header.rows > static_cast<uint64_t>(std::numeric_limits<int>::max()) ||
+        header.cols > static_cast<uint64_t>(std::numeric_limits<int>::max()))
+        assert(("The binary Matrix file has too many rows or columns", false));
+    size_t count = header.rows * header.cols;
+    if (header.offset % 64 != 0 || header.offset < sizeof(header) || header.offset > file->size ||
+        count > (file->size - header.offset) / sizeof(double))
+        assert(("The binary Matrix file is truncated", false));
+
+    MatrixView view;
+    view.rows = header.rows;
+    view.cols = header.cols;
+    view.checksum = header.checksum;
+    view.has_checksum = true;
+    const double *values = reinterpret_cast<const double *>(file->data + header.offset);
+    if (!swapped) {
+        view.data = values;
+        view.owner = file;
+        return view;
+    }
+    std::shared_ptr<std::vector<double>> copy = std::make_shared<std::vector<double>>(count);
+    for (size_t i = 0; i < count; i++) {
+        double value;
+        std::memcpy(&value, values + i, sizeof(value));
+        (*copy)[i] = byteswap(value);
+    }
+    view.data = copy->data();
+    view.owner = copy;
+    return view;
+}
+
+/// Method to read a little-endian unsigned integer of size bytes
+static uint64_t read_le(const char *p, int size) {
+    uint64_t value = 0;
+    for (int k = size - 1; k >= 0; k--)
+        value = (value << 8) | static_cast<unsigned char>(p[k]);
+    return value;
+}
+
+/// Method to append a little-endian unsigned integer of size bytes
+static void write_le(std::string &out, uint64_t value, int size) {
+    for (int k = 0; k < size; k++)
+        out.push_back(static_cast<char>((value >> (8 * k)) & 0xff));
+}
+
+/// Method to tell whether the machine stores numbers little-endian
+static bool little_endian() {
+    uint16_t one = 1;
+    char first;
+    std::memcpy(&first, &one, 1);
+    return first == 1;
+}
+
+/// Method to return the value of key in the header dictionary of a .npy file, up to the next comma
+static std::string npy_field(const std::string &header, const std::string &key) {
+    size_t pos = header.find("'" + key + "'");
+    if (pos == std::string::npos)
+        pos = header.find("\"" + key + "\"");
+    if (pos == std::string::npos)
+        assert(("The .npy header is missing a field", false));
+    pos = header.find(':', pos) + 1;
+    while (pos < header.size() && header[pos] == ' ')
+        pos++;
+    size_t stop = (header[pos] == '(') ? header.find(')', pos) + 1 : header.find(',', pos);
+    return header.substr(pos, stop - pos);
+}
+
+/** Method to read the .npy array of [p, p + size) as a MatrixView object
+   A 2-d array keeps its shape, a 1-d array is one row and a 0-d array a (1, 1) Matrix. float64
+   arrays in C order and in the byte order of the machine are returned in place, sharing owner;
+   other dtypes, byte orders and Fortran order are converted to a row-major copy of doubles.
+*/
+static MatrixView parse_npy(const char *p, size_t size, std::shared_ptr<const void> owner) {
+    if (size < 10 || std::memcmp(p, "\x93NUMPY", 6) != 0)
+        assert(("The file is not a .npy file", false));
+    int major = static_cast<unsigned char>(p[6]);
+    size_t start = (major == 1) ? 10 : 12;
+    size_t header_len = read_le(p + 8, (major == 1) ? 2 : 4);
+    if (major < 1 || major > 3 || size < start + header_len)
+        assert(("The .npy file is truncated", false));
+    std::string header(p + start, header_len);
+
+    std::string descr = npy_field(header, "descr");
+    descr.erase(std::remove(descr.begin(), descr.end(), '\''), descr.end());
+    descr.erase(std::remove(descr.begin(), descr.end(), '"'), descr.end());
+    bool fortran = npy_field(header, "fortran_order").find("True") != std::string::npos;
+    std::string shape_text = npy_field(header, "shape");
+    std::vector<uint64_t> shape;
+    for (size_t k = 0; k < shape_text.size(); k++)
+        if (std::isdigit(static_cast<unsigned char>(shape_text[k]))) {
+            size_t digits = 0;
+            shape.push_back(std::stoull(shape_text.substr(k), &digits));
+            k += digits;
+        }
+    if (shape.size() > 2)
+        assert(("Only .npy arrays of 0, 1 or 2 dimensions can be loaded", false));
+
+    MatrixView view;
+    view.rows = (shape.size() == 2) ? shape[0] : 1;
+    view.cols = shape.empty() ? 1 : shape.back();
+    size_t count = static_cast<size_t>(view.rows) * view.cols;
+
+    if (descr.size() < 3)
+        assert(("The .npy file has an unknown dtype", false));
+    char order = descr[0], kind = descr[1];
+    int itemsize = std::stoi(descr.substr(2));
+    bool swapped = itemsize > 1 && (order == (little_endian() ? '>' : '<'));
+    bool known = (kind == 'f' && (itemsize == 4 || itemsize == 8)) ||
+                 ((kind == 'i' || kind == 'u') &&
+                  (itemsize == 1 || itemsize == 2 || itemsize == 4 || itemsize == 8)) ||
+                 (kind == 'b' && itemsize == 1);
+    if (!known)
+        assert(("The .npy dtype should be a float, int, uint or bool", false));
+    const char *data = p + start + header_len;
+    if (size - start - header_len < count * itemsize)
+        assert(("The .npy file is truncated", false));
+
+    bool transposed = fortran && view.rows > 1 && view.cols > 1;
+    if (kind == 'f' && itemsize == 8 && !swapped && !transposed &&
+        reinterpret_cast<uintptr_t>(data) % alignof(double) == 0) {
+        view.data = reinterpret_cast<const double *>(data);
+        view.owner = owner;
+        return view;
+    }
+
+    std::shared_ptr<std::vector<double>> copy = std::make_shared<std::vector<double>>(count);
+    for (size_t k = 0; k < count; k++) {
+        char bytes[8];
+        std::memcpy(bytes, data + k * itemsize, itemsize);
+        if (swapped)
+            std::reverse(bytes, bytes + itemsize);
+        double value;
+        if (kind == 'f' && itemsize == 8) {
+            std::memcpy(&value, bytes, 8);
+        } else if (kind == 'f') {
+            float f;
+            std::memcpy(&f, bytes, 4);
+            value = f;
+        } else {
+            uint64_t bits = 0;
+            std::memcpy(&bits, bytes, itemsize);
+            if (!little_endian())
+                bits >>= 8 * (8 - itemsize);
+            if (kind == 'i' && itemsize < 8 && (bits >> (8 * itemsize - 1)) & 1)
+                bits |= ~uint64_t(0) << (8 * itemsize);
+            value = (kind == 'i') ? static_cast<double>(static_cast<int64_t>(bits))
+                                  : static_cast<double>(bits);
+        }
+        // Element k of a Fortran ordered array is (k % rows, k / rows)
+        size_t index = transposed ? (k % view.rows) * view.cols + k / view.rows : k;
+        (*copy)[index] = value;
+    }
+    view.data = copy->data();
+    view.owner = copy;
+    return view;
+}
+
+/** Method to build the .npy header of a (rows, cols) float64 array in C order
+   The header is padded with spaces so that the values start at a multiple of 64 bytes.
+*/
+static std::string npy_header(size_t rows, size_t cols) {
+    std::string dict = std::string("{'descr': '") + (little_endian() ? '<' : '>') +
+                       "f8', 'fortran_order': False, 'shape': (" + std::to_string(rows) + ", " +
+                       std::to_string(cols) + "), }";
+    size_t total = 10 + dict.size() + 1;
+    dict.append((64 - total % 64) % 64, ' ');
+    dict.push_back('\n');
+    std::string header = "\x93NUMPY";
+    header.push_back(1);
+    header.push_back(0);
+    write_le(header, dict.size(), 2);
+    return header + dict;
+}
+
+/// Method to check that a Matrix object holds doubles in rows of the same length
+static void check_rows(const Matrix &mat) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+    for (const std::vector<double> &row : mat.double_mat)
+        if (row.size() != mat.double_mat[0].size())
+            assert(("All the rows should have the same number of columns", false));
+}
+
+/// Method to open a NumPy .npy file as a read-only MatrixView object
+MatrixView MatrixOp::load_npy(std::string filename) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(filename, false);
+    return parse_npy(file->data, file->size, file);
+}
+
+/// Method to save a Matrix object of doubles as a 2-d float64 NumPy .npy file
+void MatrixOp::save_npy(const Matrix &mat, std::string filename) {
+    check_rows(mat);
+    size_t rows = mat.double_mat.size();
+    std::string header = npy_header(rows, rows ? mat.double_mat[0].size() : 0);
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        assert(("The file could not be opened", false));
+    file.write(header.data(), header.size());
+    for (const std::vector<double> &row : mat.double_mat)
+        file.write(reinterpret_cast<const char *>(row.data()), row.size() * sizeof(double));
+    if (!file)
+        assert(("The file could not be written", false));
+}
+
+/** Method to open the arrays of an uncompressed NumPy .npz file as MatrixView objects
+   The file is a zip archive of .npy files and is memory-mapped once. Each array is parsed where
+   it lies in the archive, so float64 arrays that are aligned are not copied. The keys are the
+   names of the arrays, without ".npy". Compressed archives (numpy.savez_compressed) are not
+   supported.
+*/
+std::map<std::string, MatrixView> MatrixOp::load_npz(std::string filename) {
+    std::shared_ptr<MappedFile> file = std::make_shared<MappedFile>(filename, false);
+    const char *zip = file->data;
+    size_t size = file->size;
+
+    // The end of central directory record is in the last 22 + 65535 bytes
+    size_t eocd = std::string::npos;
+    size_t lowest = (size > 22 + 65535) ? size - 22 - 65535 : 0;
+    if (size >= 22)
+        for (size_t k = size - 22 + 1; k-- > lowest;)
+            if (read_le(zip + k, 4) == 0x06054b50) {
+                eocd = k;
+                break;
+            }
+    if (eocd == std::string::npos)
+        assert(("The file is not a .npz file", false));
+    uint64_t entries = read_le(zip + eocd + 10, 2);
+    uint64_t directory = read_le(zip + eocd + 16, 4);
+    if ((entries == 0xffff || directory == 0xffffffff) && eocd >= 20 &&
+        read_le(zip + eocd - 20, 4) == 0x07064b50) {
+        size_t zip64 = read_le(zip + eocd - 12, 8);
+        if (zip64 + 56 > size || read_le(zip + zip64, 4) != 0x06064b50)
+            assert(("The .npz file is truncated", false));
+        entries = read_le(zip + zip64 + 32, 8);
+        directory = read_le(zip + zip64 + 48, 8);
+    }
+
+    std::map<std::string, MatrixView> result;
+    size_t pos = directory;
+    for (uint64_t e = 0; e < entries; e++) {
+        if (pos + 46 > size || read_le(zip + pos, 4) != 0x02014b50)
+            assert(("The .npz file is truncated", false));
+        int method = read_le(zip + pos + 10, 2);
+        uint64_t compressed = read_le(zip + pos + 20, 4);
+        uint64_t uncompressed = read_le(zip + pos + 24, 4);
+        size_t name_len = read_le(zip + pos + 28, 2), extra_len = read_le(zip + pos + 30, 2);
+        size_t comment_len = read_le(zip + pos + 32, 2);
+        uint64_t local = read_le(zip + pos + 42, 4);
+        if (pos + 46 + name_len + extra_len + comment_len > size)
+            assert(("The .npz file is truncated", false));
+        std::string name(zip + pos + 46, name_len);
+
+        // ZIP64 extra field: the 64-bit values of the fields set to 0xffffffff, in this order
+        const char *extra = zip + pos + 46 + name_len;
+        for (size_t x = 0; x + 4 <= extra_len;) {
+            size_t id = read_le(extra + x, 2), len = read_le(extra + x + 2, 2);
+            if (x + 4 + len > extra_len)
+                assert(("The .npz file is truncated", false));
+            if (id == 0x0001) {
+                const char *field = extra + x + 4;
+                size_t needed = 8 * ((uncompressed == 0xffffffff) + (compressed == 0xffffffff) +
+                                     (local == 0xffffffff));
+                if (len < needed)
+                    assert(("The .npz file is truncated", false));
+                if (uncompressed == 0xffffffff) {
+                    uncompressed = read_le(field, 8);
+                    field += 8;
+                }
+                if (compressed == 0xffffffff) {
+                    compressed = read_le(field, 8);
+                    field += 8;
+                }
+                if (local == 0xffffffff)
+                    local = read_le(field, 8);
+            }
+            x += 4 + len;
+        }
+        pos += 46 + name_len + extra_len + comment_len;
+
+        if (method != 0)
+            assert(("Compressed .npz files are not supported, save them with numpy.savez", false));
+        // local and compressed may come from the ZIP64 field, so they are compared without sums
+        if (local > size || size - local < 30 || read_le(zip + local, 4) != 0x04034b50)
+            assert(("The .npz file is truncated", false));
+        size_t data = local + 30 + read_le(zip + local + 26, 2) + read_le(zip + local + 28, 2);
+        if (data > size || compressed > size - data)
+            assert(("The .npz file is truncated", false));
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".npy") == 0)
+            name.resize(name.size() - 4);
+        result[name] = parse_npy(zip + data, compressed, file);
+    }
+    return result;
+}
+
+/// Method to compute the CRC-32 of a zip entry, fed one run of bytes after the other
+static uint32_t crc32(uint32_t crc, const char *p, size_t n) {
+    static const std::vector<uint32_t> table = [] {
+        std::vector<uint32_t> t(256);
+        for (uint32_t i = 0; i < 256; i++) {
+            uint32_t c = i;
+            for (int k = 0; k < 8; k++)
+                c = (c & 1) ? 0xedb88320 ^ (c >> 1) : c >> 1;
+            t[i] = c;
+        }
+        return t;
+    }();
+    crc = ~crc;
+    for (size_t i = 0; i < n; i++)
+        crc = table[(crc ^ static_cast<unsigned char>(p[i])) & 0xff] ^ (crc >> 8);
+    return ~crc;
+}
+
+/** Method to save Matrix objects of doubles as an uncompressed NumPy .npz file
+   Each Matrix is stored as "<name>.npy" without compression, which numpy.load reads. The local
+   headers are padded with an extra field so that the values of every array start at a multiple
+   of 64 bytes, and load_npz() can map them without copying.
+*/
+void MatrixOp::save_npz(const std::map<std::string, Matrix> &arrays, std::string filename) {
+    std::ofstream file(filename, std::ios::binary);
+    if (!file)
+        assert(("The file could not be opened", false));
+    std::string directory;
+    uint64_t offset = 0;
+    for (const std::pair<const std::string, Matrix> &array : arrays) {
+        const Matrix &mat = array.second;
+        check_rows(mat);
+        std::string name = array.first + ".npy";
+        size_t rows = mat.double_mat.size(), cols = rows ? mat.double_mat[0].size() : 0;
+        std::string header = npy_header(rows, cols);
+        uint64_t size = header.size() + rows * cols * sizeof(double);
+        uint32_t crc = crc32(0, header.data(), header.size());
+        for (const std::vector<double> &row : mat.double_mat)
+            crc = crc32(crc, reinterpret_cast<const char *>(row.data()),
+                        row.size() * sizeof(double));
+        if (offset + size + 1024 >= 0xffffffff)
+            assert(("The .npz file would need ZIP64, which save_npz() does not write", false));
+
+        // 0xd935 is the padding field of zipalign, which readers skip
+        size_t before = offset + 30 + name.size() + 4 + header.size();
+        size_t pad = (64 - before % 64) % 64;
+        std::string local;
+        write_le(local, 0x04034b50, 4);
+        write_le(local, 20, 2);
+        write_le(local, 0, 2);
+        write_le(local, 0, 2);
+        write_le(local, 0, 2);
+        write_le(local, 0x21, 2);
+        write_le(local, crc, 4);
+        write_le(local, size, 4);
+        write_le(local, size, 4);
+        write_le(local, name.size(), 2);
+        write_le(local, 4 + pad, 2);
+        local += name;
+        write_le(local, 0xd935, 2);
+        write_le(local, pad, 2);
+        local.append(pad, '\0');
+        file.write(local.data(), local.size());
+        file.write(header.data(), header.size());
+        for (const std::vector<double> &row : mat.double_mat)
+            file.write(reinterpret_cast<const char *>(row.data()), row.size() * sizeof(double));
+
+        write_le(directory, 0x02014b50, 4);
+        write_le(directory, 20, 2);
+        write_le(directory, 20, 2);
+        write_le(directory, 0, 2);
+        write_le(directory, 0, 2);
+        write_le(directory, 0, 2);
+        write_le(directory, 0x21, 2);
+        write_le(directory, crc, 4);
+        write_le(directory, size, 4);
+        write_le(directory, size, 4);
+        write_le(directory, name.size(), 2);
+        write_le(directory, 0, 2);
+        write_le(directory, 0, 2);
+        write_le(directory, 0, 2);
+        write_le(directory, 0, 2);
+        write_le(directory, 0, 4);
+        write_le(directory, offset, 4);
+        directory += name;
+        offset += local.size() + size;
+    }
+
+    std::string end;
+    write_le(end, 0x06054b50, 4);
+    write_le(end, 0, 2);
+    write_le(end, 0, 2);
+    write_le(end, arrays.size(), 2);
+    write_le(end, arrays.size(), 2);
+    write_le(end, directory.size(), 4);
+    write_le(end, offset, 4);
+    write_le(end, 0, 2);
+    file.write(directory.data(), directory.size());
+    file.write(end.data(), end.size());
+    if (!file)
+        assert(("The file could not be written", false));
+}
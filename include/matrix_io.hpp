@@ -0,0 +1,32 @@
+#ifndef _matrix_io_hpp_
+#define _matrix_io_hpp_
+
+#include <matrix_basic.hpp>
+
+#include <cstdint>
+#include <map>
+#include <memory>
+
+/** Read-only (rows, cols) Matrix of doubles stored in a contiguous row-major buffer
+   Returned by MatrixOp::load() and load_npy(). data points into the memory-mapped file, which
+   stays mapped as long as a copy of the view holds owner, so opening a file does not read its
+   values; when the values had to be converted owner holds the converted copy instead. checksum
+   is the one stored by save(), verify() reads all the values to compare them with it. Views read
+   from .npy and .npz files have no checksum, has_checksum is false and verify() returns true.
+*/
+class MatrixView {
+  public:
+    int rows = 0;
+    int cols = 0;
+    const double *data = nullptr;
+    uint64_t checksum = 0;
+    bool has_checksum = false;
+    std::shared_ptr<const void> owner;
+
+    // Member functions
+    double get(int, int) const;
+    Matrix to_matrix() const;
+    bool verify() const;
+};
+
+#endif /* _matrix_io_hpp_ */
@@ -0,0 +1,1111 @@
+#include <matrix_kernels.hpp>
+
+#include <atomic>
+#include <charconv>
+#include <limits>
+#include <memory>
+
+namespace kernels {
+
+static std::atomic<int> thread_count(std::max(1u, std::thread::hardware_concurrency()));
+static thread_local bool inside_parallel_for = false;
+
+/// Method to start workers until the pool has at least size of them
+void ThreadPool::reserve(int size) {
+    std::unique_lock<std::mutex> lock(mutex);
+    while (static_cast<int>(workers.size()) < size) {
+        workers.emplace_back([this] {
+            while (true) {
+                std::function<void()> task;
+                {
+                    std::unique_lock<std::mutex> lock(mutex);
+                    cv.wait(lock, [this] { return stop || !tasks.empty(); });
+                    if (stop && tasks.empty())
+                        return;
+                    task = std::move(tasks.front());
+                    tasks.pop();
+                }
+                task();
+            }
+        });
+    }
+}
+
+ThreadPool::~ThreadPool() {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        stop = true;
+    }
+    cv.notify_all();
+    for (std::thread &worker : workers)
+        worker.join();
+}
+
+/// Method to queue a task to be run by one of the workers
+void ThreadPool::submit(std::function<void()> task) {
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        tasks.push(std::move(task));
+    }
+    cv.notify_one();
+}
+
+/// Method to get the pool shared by all kernels
+ThreadPool &ThreadPool::instance() {
+    static ThreadPool pool;
+    return pool;
+}
+
+/// Method to get the number of threads used by the parallel kernels
+int num_threads() { return thread_count; }
+
+/// Method to set the number of threads used by the parallel kernels
+void set_num_threads(int count) { thread_count = std::max(count, 1); }
+
+/// Method to run fn over [begin, end) in chunks of grain iterations on num_threads() threads
+void parallel_for(int begin, int end, int grain, const std::function<void(int, int)> &fn) {
+    parallel_for(begin, end, grain, num_threads(), fn);
+}
+
+/** Method to run fn over [begin, end) in chunks of grain iterations on at most threads threads
+   Chunks are handed out dynamically from an atomic counter so that uneven chunks (e.g. the rows
+   of a triangular update) stay balanced across threads.
+*/
+void parallel_for(int begin, int end, int grain, int threads,
+                  const std::function<void(int, int)> &fn) {
+    if (end <= begin)
+        return;
+    grain = std::max(grain, 1);
+    int chunks = (end - begin + grain - 1) / grain;
+    int helpers = std::min(threads, chunks) - 1;
+    if (helpers <= 0 || inside_parallel_for) {
+        fn(begin, end);
+        return;
+    }
+
+    struct Job {
+        std::atomic<int> next{0};
+        int done = 0;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+    std::shared_ptr<Job> job = std::make_shared<Job>();
+    const std::function<void(int, int)> *body = &fn;
+
+    auto work = [job, body, begin, end, grain, chunks] {
+        bool was_inside = inside_parallel_for;
+        inside_parallel_for = true;
+        int count = 0;
+        for (int c = job->next++; c < chunks; c = job->next++) {
+            int chunk_begin = begin + c * grain;
+            (*body)(chunk_begin, std::min(chunk_begin + grain, end));
+            count++;
+        }
+        inside_parallel_for = was_inside;
+        if (count > 0) {
+            std::unique_lock<std::mutex> lock(job->mutex);
+            job->done += count;
+            if (job->done == chunks)
+                job->cv.notify_all();
+        }
+    };
+
+    ThreadPool &pool = ThreadPool::instance();
+    pool.reserve(helpers);
+    for (int i = 0; i < helpers; i++)
+        pool.submit(work);
+    work();
+
+    std::unique_lock<std::mutex> lock(job->mutex);
+    job->cv.wait(lock, [&] { return job->done == chunks; });
+}
+
+/// Method to copy the double values of a Matrix object into a contiguous row-major buffer
+std::vector<double> pack(const Matrix &mat) {
+    int rows = mat.double_mat.size();
+    int cols = rows > 0 ? mat.double_mat[0].size() : 0;
+    std::vector<double> buf(static_cast<size_t>(rows) * cols);
+    for (int i = 0; i < rows; i++)
+        std::copy(mat.double_mat[i].begin(), mat.double_mat[i].end(),
+                  buf.begin() + static_cast<size_t>(i) * cols);
+    return buf;
+}
+
+/// Method to build a Matrix object from a contiguous row-major buffer
+Matrix unpack(const std::vector<double> &buf, int rows, int cols) {
+    Matrix mat;
+    mat.double_mat.resize(rows);
+    for (int i = 0; i < rows; i++)
+        mat.double_mat[i].assign(buf.begin() + static_cast<size_t>(i) * cols,
+                                 buf.begin() + static_cast<size_t>(i + 1) * cols);
+    mat.to_string();
+    return mat;
+}
+
+/// Method to parse a whole cell of text as a double, allowing surrounding spaces and a leading '+'
+bool parse_double(const char *begin, const char *end, double &value) {
+    while (begin < end && (*begin == ' ' || *begin == '\t'))
+        begin++;
+    while (end > begin && (end[-1] == ' ' || end[-1] == '\t'))
+        end--;
+    if (begin < end && *begin == '+')
+        begin++;
+    if (begin == end)
+        return false;
+    std::from_chars_result parsed = std::from_chars(begin, end, value);
+    return parsed.ec == std::errc() && parsed.ptr == end;
+}
+
+/// Method to write the shortest text that parses back to value and return the end of it
+char *format_double(char *p, double value) {
+    return std::to_chars(p, p + double_chars, value).ptr;
+}
+
+/** C = alpha * A * B + beta * C
+   The loops are blocked over rows of A and over k so that a strip of B stays in cache, and the
+   innermost loop runs over contiguous columns of B and C so that the compiler vectorizes it.
+*/
+template <typename T>
+static void gemm_kernel(int m, int n, int k, T alpha, const T *a, int lda, const T *b, int ldb,
+                        T beta, T *c, int ldc) {
+    const int mc = 64, kc = 256;
+
+    if (beta != 1) {
+        for (int i = 0; i < m; i++) {
+            T *c_row = c + static_cast<size_t>(i) * ldc;
+            for (int j = 0; j < n; j++)
+                c_row[j] = (beta == 0) ? 0 : beta * c_row[j];
+        }
+    }
+    if (alpha == 0 || k == 0)
+        return;
+
+    for (int kk = 0; kk < k; kk += kc) {
+        int k_end = std::min(kk + kc, k);
+        for (int ii = 0; ii < m; ii += mc) {
+            int i_end = std::min(ii + mc, m);
+            for (int i = ii; i < i_end; i++) {
+                T *c_row = c + static_cast<size_t>(i) * ldc;
+                const T *a_row = a + static_cast<size_t>(i) * lda;
+                for (int p = kk; p < k_end; p++) {
+                    // Zeros of A are not skipped, 0 * Inf and 0 * NaN must still give NaN
+                    T a_ip = alpha * a_row[p];
+                    const T *b_row = b + static_cast<size_t>(p) * ldb;
+                    for (int j = 0; j < n; j++)
+                        c_row[j] += a_ip * b_row[j];
+                }
+            }
+        }
+    }
+}
+
+/// Same as gemm_kernel, with the rows of C split across threads for large products
+template <typename T>
+static void gemm_rows(int m, int n, int k, T alpha, const T *a, int lda, const T *b, int ldb,
+                      T beta, T *c, int ldc) {
+    double flops = 2.0 * m * n * k;
+    int threads = num_threads();
+    if (threads == 1 || flops < 4e6 || m < 2) {
+        gemm_kernel(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+        return;
+    }
+    int grain = std::max(8, m / (4 * threads));
+    parallel_for(0, m, grain, [&](int i0, int i1) {
+        gemm_kernel(i1 - i0, n, k, alpha, a + static_cast<size_t>(i0) * lda, lda, b, ldb, beta,
+                    c + static_cast<size_t>(i0) * ldc, ldc);
+    });
+}
+
+/// C = alpha * A * B + beta * C on the calling thread
+void gemm_serial(int m, int n, int k, double alpha, const double *a, int lda, const double *b,
+                 int ldb, double beta, double *c, int ldc) {
+    gemm_kernel(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+/// C = alpha * A * B + beta * C, with the rows of C split across threads for large products
+void gemm(int m, int n, int k, double alpha, const double *a, int lda, const double *b, int ldb,
+          double beta, double *c, int ldc) {
+    gemm_rows(m, n, k, alpha, a, lda, b, ldb, beta, c, ldc);
+}
+
+/// Solve L * X = B in place, L lower triangular with a unit or a general diagonal
+template <typename T>
+static void trsm_lower_impl(const T *l, int n, int ldl, T *b, int nrhs, int ldb, bool unit) {
+    for (int ib = 0; ib < n; ib += block_size) {
+        int i_end = std::min(ib + block_size, n);
+        if (ib > 0)
+            gemm_rows<T>(i_end - ib, nrhs, ib, -1, l + static_cast<size_t>(ib) * ldl, ldl, b, ldb,
+                         1, b + static_cast<size_t>(ib) * ldb, ldb);
+        for (int i = ib; i < i_end; i++) {
+            T *b_i = b + static_cast<size_t>(i) * ldb;
+            const T *l_i = l + static_cast<size_t>(i) * ldl;
+            for (int j = ib; j < i; j++) {
+                T l_ij = l_i[j];
+                const T *b_j = b + static_cast<size_t>(j) * ldb;
+                for (int c = 0; c < nrhs; c++)
+                    b_i[c] -= l_ij * b_j[c];
+            }
+            if (!unit) {
+                T inv_diag = 1 / l_i[i];
+                for (int c = 0; c < nrhs; c++)
+                    b_i[c] *= inv_diag;
+            }
+        }
+    }
+}
+
+/// Solve U * X = B in place, U upper triangular
+template <typename T>
+static void trsm_upper_impl(const T *u, int n, int ldu, T *b, int nrhs, int ldb) {
+    for (int i_end = n; i_end > 0; i_end -= block_size) {
+        int ib = std::max(i_end - block_size, 0);
+        if (i_end < n)
+            gemm_rows<T>(i_end - ib, nrhs, n - i_end, -1, u + static_cast<size_t>(ib) * ldu + i_end,
+                         ldu, b + static_cast<size_t>(i_end) * ldb, ldb, 1,
+                         b + static_cast<size_t>(ib) * ldb, ldb);
+        for (int i = i_end - 1; i >= ib; i--) {
+            T *b_i = b + static_cast<size_t>(i) * ldb;
+            const T *u_i = u + static_cast<size_t>(i) * ldu;
+            for (int j = i + 1; j < i_end; j++) {
+                T u_ij = u_i[j];
+                const T *b_j = b + static_cast<size_t>(j) * ldb;
+                for (int c = 0; c < nrhs; c++)
+                    b_i[c] -= u_ij * b_j[c];
+            }
+            T inv_diag = 1 / u_i[i];
+            for (int c = 0; c < nrhs; c++)
+                b_i[c] *= inv_diag;
+        }
+    }
+}
+
+/// Solve L * X = B in place, L unit lower triangular
+void trsm_lower_unit(const double *l, int n, int ldl, double *b, int nrhs, int ldb) {
+    trsm_lower_impl(l, n, ldl, b, nrhs, ldb, true);
+}
+
+/// Solve L * X = B in place, L lower triangular with a general diagonal
+void trsm_lower(const double *l, int n, int ldl, double *b, int nrhs, int ldb) {
+    trsm_lower_impl(l, n, ldl, b, nrhs, ldb, false);
+}
+
+/// Solve U * X = B in place, U upper triangular
+void trsm_upper(const double *u, int n, int ldu, double *b, int nrhs, int ldb) {
+    trsm_upper_impl(u, n, ldu, b, nrhs, ldb);
+}
+
+/** Unblocked LU factorization of the panel a[k0:n, k0:k_end]
+   Row swaps are applied to the columns [swap_begin, swap_end) only, the caller takes care of the
+   other columns.
+*/
+template <typename T>
+static void lu_panel(T *a, int n, int lda, int k0, int k_end, int *piv, double tol, int &sign,
+                     bool &singular, int swap_begin, int swap_end) {
+    for (int j = k0; j < k_end; j++) {
+        int p = j;
+        double p_val = std::abs(a[static_cast<size_t>(j) * lda + j]);
+        for (int i = j + 1; i < n; i++) {
+            double val = std::abs(a[static_cast<size_t>(i) * lda + j]);
+            if (val > p_val) {
+                p_val = val;
+                p = i;
+            }
+        }
+        piv[j] = p;
+        if (p != j) {
+            std::swap_ranges(a + static_cast<size_t>(j) * lda + swap_begin,
+                             a + static_cast<size_t>(j) * lda + swap_end,
+                             a + static_cast<size_t>(p) * lda + swap_begin);
+            sign = -sign;
+        }
+        if (p_val <= tol)
+            singular = true;
+        if (p_val == 0)
+            continue;
+
+        const T *a_j = a + static_cast<size_t>(j) * lda;
+        T inv_pivot = 1 / a_j[j];
+        for (int i = j + 1; i < n; i++) {
+            T *a_i = a + static_cast<size_t>(i) * lda;
+            T l_ij = a_i[j] * inv_pivot;
+            a_i[j] = l_ij;
+            for (int c = j + 1; c < k_end; c++)
+                a_i[c] -= l_ij * a_j[c];
+        }
+    }
+}
+
+/** Task-parallel LU factorization with lookahead
+   The Matrix is split in block columns. Task panel(k) factorizes block column k and task
+   update(k, j) applies the row swaps, the triangular solve and the gemm update of panel k to
+   block column j > k. update(k, j) waits for panel(k) and update(k - 1, j), while panel(k + 1)
+   only waits for update(k, k + 1), so the next panel is factorized while the rest of the
+   trailing matrix is still being updated. Ready tasks on that critical path are picked first.
+   Panels only swap rows inside their own block column, the swaps left of each panel are applied
+   once all tasks are done.
+*/
+static bool lu_factor_tasks(double *a, int n, int lda, int *piv, int &sign, double tol) {
+    struct Task {
+        int k, j;
+        bool critical() const { return j <= k + 1; }
+    };
+    struct Later {
+        bool operator()(const Task &x, const Task &y) const {
+            if (x.critical() != y.critical())
+                return y.critical();
+            return (x.k != y.k) ? x.k > y.k : x.j > y.j;
+        }
+    };
+    struct State {
+        double *a;
+        int n, lda, nb;
+        int *piv;
+        double tol;
+        int sign = 1;
+        bool singular = false;
+        std::vector<int> deps;
+        std::priority_queue<Task, std::vector<Task>, Later> ready;
+        int remaining;
+        std::mutex mutex;
+        std::condition_variable cv;
+    };
+
+    std::shared_ptr<State> st = std::make_shared<State>();
+    st->a = a;
+    st->n = n;
+    st->lda = lda;
+    st->nb = (n + block_size - 1) / block_size;
+    st->piv = piv;
+    st->tol = tol;
+    int nb = st->nb;
+
+    // deps[k * nb + j] counts the unfinished tasks that update(k, j), or panel(k) for j == k,
+    // is waiting for
+    st->deps.assign(static_cast<size_t>(nb) * nb, 0);
+    for (int k = 0; k < nb; k++) {
+        if (k > 0)
+            st->deps[static_cast<size_t>(k) * nb + k] = 1;
+        for (int j = k + 1; j < nb; j++)
+            st->deps[static_cast<size_t>(k) * nb + j] = (k > 0) ? 2 : 1;
+    }
+    st->remaining = nb + nb * (nb - 1) / 2;
+    st->ready.push({0, 0});
+
+    auto run = [](State &s, Task t) {
+        int k0 = t.k * block_size, k_end = std::min(k0 + block_size, s.n);
+        if (t.j == t.k) {
+            lu_panel(s.a, s.n, s.lda, k0, k_end, s.piv, s.tol, s.sign, s.singular, k0, k_end);
+            return;
+        }
+        int c0 = t.j * block_size, c1 = std::min(c0 + block_size, s.n);
+        for (int i = k0; i < k_end; i++) {
+            if (s.piv[i] != i)
+                std::swap_ranges(s.a + static_cast<size_t>(i) * s.lda + c0,
+                                 s.a + static_cast<size_t>(i) * s.lda + c1,
+                                 s.a + static_cast<size_t>(s.piv[i]) * s.lda + c0);
+        }
+        double *a11 = s.a + static_cast<size_t>(k0) * s.lda + k0;
+        double *a12 = s.a + static_cast<size_t>(k0) * s.lda + c0;
+        trsm_lower_unit(a11, k_end - k0, s.lda, a12, c1 - c0, s.lda);
+        gemm_serial(s.n - k_end, c1 - c0, k_end - k0, -1,
+                    s.a + static_cast<size_t>(k_end) * s.lda + k0, s.lda, a12, s.lda, 1,
+                    s.a + static_cast<size_t>(k_end) * s.lda + c0, s.lda);
+    };
+
+    auto work = [st, run] {
+        State &s = *st;
+        bool was_inside = inside_parallel_for;
+        inside_parallel_for = true;
+        std::unique_lock<std::mutex> lock(s.mutex);
+        while (true) {
+            s.cv.wait(lock, [&] { return !s.ready.empty() || s.remaining == 0; });
+            if (s.remaining == 0)
+                break;
+            Task t = s.ready.top();
+            s.ready.pop();
+            lock.unlock();
+            run(s, t);
+            lock.lock();
+
+            s.remaining--;
+            auto release = [&](int k, int j) {
+                if (--s.deps[static_cast<size_t>(k) * s.nb + j] == 0)
+                    s.ready.push({k, j});
+            };
+            if (t.j == t.k) {
+                for (int j = t.k + 1; j < s.nb; j++)
+                    release(t.k, j);
+            } else {
+                release(t.k + 1, t.j);
+            }
+            s.cv.notify_all();
+        }
+        inside_parallel_for = was_inside;
+    };
+
+    ThreadPool &pool = ThreadPool::instance();
+    int helpers = num_threads() - 1;
+    pool.reserve(helpers);
+    for (int i = 0; i < helpers; i++)
+        pool.submit(work);
+    work();
+
+    // All tasks are done once work() returns on this thread
+    for (int k = 1; k < nb; k++) {
+        int k0 = k * block_size, k_end = std::min(k0 + block_size, n);
+        for (int i = k0; i < k_end; i++) {
+            if (piv[i] != i)
+                std::swap_ranges(a + static_cast<size_t>(i) * lda,
+                                 a + static_cast<size_t>(i) * lda + k0,
+                                 a + static_cast<size_t>(piv[i]) * lda);
+        }
+    }
+    sign = st->sign;
+    return st->singular;
+}
+
+/** Blocked right-looking LU factorization with partial pivoting
+   Each step factorizes a panel of block_size columns, solves for the matching block row of U
+   and updates the trailing matrix with a single gemm call, so that O(n^3) work runs in gemm.
+*/
+template <typename T>
+static bool lu_factor_blocked(T *a, int n, int lda, int *piv, int &sign, double tol) {
+    bool singular = false;
+    sign = 1;
+    for (int k0 = 0; k0 < n; k0 += block_size) {
+        int kb = std::min(block_size, n - k0);
+        int k_end = k0 + kb;
+
+        lu_panel(a, n, lda, k0, k_end, piv, tol, sign, singular, 0, n);
+        if (k_end == n)
+            break;
+
+        // U12 = L11^-1 * A12
+        T *a11 = a + static_cast<size_t>(k0) * lda + k0;
+        trsm_lower_impl(a11, kb, lda, a11 + kb, n - k_end, lda, true);
+
+        // A22 = A22 - L21 * U12
+        gemm_rows<T>(n - k_end, n - k_end, kb, -1, a + static_cast<size_t>(k_end) * lda + k0, lda,
+                     a11 + kb, lda, 1, a + static_cast<size_t>(k_end) * lda + k_end, lda);
+    }
+    return singular;
+}
+
+/** LU factorization with partial pivoting
+   With more than one thread and at least three block columns, the steps of the blocked
+   factorization are run as dependent tasks by lu_factor_tasks.
+*/
+bool lu_factor(double *a, int n, int lda, int *piv, int &sign) {
+    double max_abs = 0;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            max_abs = std::max(max_abs, std::abs(a[static_cast<size_t>(i) * lda + j]));
+    double tol = n * std::numeric_limits<double>::epsilon() * max_abs;
+
+    if (num_threads() > 1 && !inside_parallel_for && n > 2 * block_size)
+        return lu_factor_tasks(a, n, lda, piv, sign, tol) || (max_abs == 0);
+    return lu_factor_blocked(a, n, lda, piv, sign, tol) || (max_abs == 0);
+}
+
+/** Single precision LU factorization with partial pivoting
+   Only exactly zero pivots are flagged, since a float factorization is only used as a
+   preconditioner for refinement in double precision.
+*/
+bool lu_factor_float(float *a, int n, int lda, int *piv) {
+    int sign;
+    lu_factor_blocked(a, n, lda, piv, sign, 0.0);
+    for (int i = 0; i < n; i++) {
+        float u_ii = a[static_cast<size_t>(i) * lda + i];
+        if (u_ii == 0 || !std::isfinite(u_ii))
+            return true;
+    }
+    return false;
+}
+
+/// Solve A * X = B in place for a (n, nrhs) B, using the output of lu_factor_float
+void lu_solve_float(const float *lu, int n, int lda, const int *piv, float *b, int nrhs, int ldb) {
+    for (int i = 0; i < n; i++) {
+        if (piv[i] != i)
+            std::swap_ranges(b + static_cast<size_t>(i) * ldb,
+                             b + static_cast<size_t>(i) * ldb + nrhs,
+                             b + static_cast<size_t>(piv[i]) * ldb);
+    }
+    trsm_lower_impl(lu, n, lda, b, nrhs, ldb, true);
+    trsm_upper_impl(lu, n, lda, b, nrhs, ldb);
+}
+
+/// Apply the row swaps recorded by lu_factor to a (n, nrhs) right hand side
+void lu_permute(const int *piv, int n, double *b, int nrhs, int ldb) {
+    for (int i = 0; i < n; i++) {
+        if (piv[i] != i)
+            std::swap_ranges(b + static_cast<size_t>(i) * ldb,
+                             b + static_cast<size_t>(i) * ldb + nrhs,
+                             b + static_cast<size_t>(piv[i]) * ldb);
+    }
+}
+
+/** Solve L^T * X = B in place
+   Once row i of X is known it is eliminated from the rows above it using row i of L, which is
+   contiguous, so the updates are vectorized over the right hand sides.
+*/
+void trsm_lower_trans(const double *l, int n, int ldl, double *b, int nrhs, int ldb) {
+    for (int i = n - 1; i >= 0; i--) {
+        double *b_i = b + static_cast<size_t>(i) * ldb;
+        const double *l_i = l + static_cast<size_t>(i) * ldl;
+        double inv_diag = 1 / l_i[i];
+        for (int c = 0; c < nrhs; c++)
+            b_i[c] *= inv_diag;
+        for (int p = 0; p < i; p++) {
+            double l_ip = l_i[p];
+            if (l_ip == 0)
+                continue;
+            double *b_p = b + static_cast<size_t>(p) * ldb;
+            for (int c = 0; c < nrhs; c++)
+                b_p[c] -= l_ip * b_i[c];
+        }
+    }
+}
+
+/** Blocked right-looking Cholesky factorization
+   Each step factorizes a diagonal block, solves for the panel below it (rows in parallel) and
+   applies the symmetric rank-k update to the trailing lower triangle with gemm over row blocks
+   in parallel, using a transposed copy of the panel so that the inner loop is contiguous.
+*/
+bool cholesky_factor(double *a, int n, int lda) {
+    std::vector<double> panel_t;
+    for (int k0 = 0; k0 < n; k0 += block_size) {
+        int kb = std::min(block_size, n - k0);
+        int k_end = k0 + kb;
+
+        // Unblocked factorization of the diagonal block
+        for (int j = k0; j < k_end; j++) {
+            double *a_j = a + static_cast<size_t>(j) * lda;
+            double d = a_j[j];
+            for (int p = k0; p < j; p++)
+                d -= a_j[p] * a_j[p];
+            if (!(d > 0) || !std::isfinite(d))
+                return false;
+            a_j[j] = std::sqrt(d);
+            for (int i = j + 1; i < k_end; i++) {
+                double *a_i = a + static_cast<size_t>(i) * lda;
+                double s = a_i[j];
+                for (int p = k0; p < j; p++)
+                    s -= a_i[p] * a_j[p];
+                a_i[j] = s / a_j[j];
+            }
+        }
+
+        if (k_end == n)
+            break;
+        int m = n - k_end;
+
+        // L21 = A21 * L11^-T, every row is independent
+        parallel_for(k_end, n, 32, [&](int i0, int i1) {
+            for (int i = i0; i < i1; i++) {
+                double *a_i = a + static_cast<size_t>(i) * lda;
+                for (int j = k0; j < k_end; j++) {
+                    const double *a_j = a + static_cast<size_t>(j) * lda;
+                    double s = a_i[j];
+                    for (int p = k0; p < j; p++)
+                        s -= a_i[p] * a_j[p];
+                    a_i[j] = s / a_j[j];
+                }
+            }
+        });
+
+        // A22 = A22 - L21 * L21^T on the lower triangle
+        panel_t.assign(static_cast<size_t>(kb) * m, 0);
+        for (int i = 0; i < m; i++) {
+            const double *l_i = a + static_cast<size_t>(k_end + i) * lda + k0;
+            for (int p = 0; p < kb; p++)
+                panel_t[static_cast<size_t>(p) * m + i] = l_i[p];
+        }
+        parallel_for(0, m, 16, [&](int i0, int i1) {
+            gemm_serial(i1 - i0, i1, kb, -1, a + static_cast<size_t>(k_end + i0) * lda + k0, lda,
+                        panel_t.data(), m, 1, a + static_cast<size_t>(k_end + i0) * lda + k_end,
+                        lda);
+        });
+    }
+
+    for (int i = 0; i < n; i++) {
+        double *a_i = a + static_cast<size_t>(i) * lda;
+        std::fill(a_i + i + 1, a_i + n, 0);
+    }
+    return true;
+}
+
+/** Unblocked Householder QR of the panel a[0:m, 0:kb] with trailing columns up to n
+   Every reflector is applied to the remaining columns of the panel only; the columns after the
+   panel are updated by the caller with the block reflector.
+*/
+static void qr_panel(double *a, int m, int kb, int lda, double *tau) {
+    std::vector<double> w(kb);
+    for (int j = 0; j < kb && j < m; j++) {
+        double alpha = a[static_cast<size_t>(j) * lda + j];
+        double x_norm = 0;
+        for (int i = j + 1; i < m; i++)
+            x_norm = std::hypot(x_norm, a[static_cast<size_t>(i) * lda + j]);
+        if (x_norm == 0) {
+            tau[j] = 0;
+            continue;
+        }
+        double beta = -std::copysign(std::hypot(alpha, x_norm), alpha);
+        tau[j] = (beta - alpha) / beta;
+        double scale = 1 / (alpha - beta);
+        for (int i = j + 1; i < m; i++)
+            a[static_cast<size_t>(i) * lda + j] *= scale;
+        a[static_cast<size_t>(j) * lda + j] = beta;
+
+        // a[j:m, j+1:kb] -= tau * v * (v^T * a[j:m, j+1:kb])
+        int nc = kb - j - 1;
+        if (nc == 0)
+            continue;
+        double *a_j = a + static_cast<size_t>(j) * lda + j + 1;
+        std::copy(a_j, a_j + nc, w.begin());
+        for (int i = j + 1; i < m; i++) {
+            const double *a_i = a + static_cast<size_t>(i) * lda;
+            double v_i = a_i[j];
+            for (int c = 0; c < nc; c++)
+                w[c] += v_i * a_i[j + 1 + c];
+        }
+        for (int c = 0; c < nc; c++)
+            w[c] *= tau[j];
+        for (int c = 0; c < nc; c++)
+            a_j[c] -= w[c];
+        for (int i = j + 1; i < m; i++) {
+            double *a_i = a + static_cast<size_t>(i) * lda;
+            double v_i = a_i[j];
+            for (int c = 0; c < nc; c++)
+                a_i[j + 1 + c] -= v_i * w[c];
+        }
+    }
+}
+
+/** Block reflector H = I - V * T * V^T of kb Householder vectors stored below the diagonal of
+   a[0:m, 0:kb]. V is copied out with its unit diagonal, together with its transpose, so that the
+   products with V and V^T are both plain gemm calls.
+*/
+struct BlockReflector {
+    int m, kb;
+    std::vector<double> v, v_t, t, w;
+
+    BlockReflector(const double *a, int m, int kb, int lda, const double *tau) : m(m), kb(kb) {
+        v.assign(static_cast<size_t>(m) * kb, 0);
+        v_t.assign(static_cast<size_t>(kb) * m, 0);
+        for (int i = 0; i < m; i++) {
+            for (int j = 0; j < kb && j <= i; j++) {
+                double v_ij = (i == j) ? 1 : a[static_cast<size_t>(i) * lda + j];
+                v[static_cast<size_t>(i) * kb + j] = v_ij;
+                v_t[static_cast<size_t>(j) * m + i] = v_ij;
+            }
+        }
+
+        // T is upper triangular: T[0:j, j] = -tau_j * T[0:j, 0:j] * V[:, 0:j]^T * v_j
+        t.assign(static_cast<size_t>(kb) * kb, 0);
+        std::vector<double> vtv(kb);
+        for (int j = 0; j < kb; j++) {
+            for (int p = 0; p < j; p++) {
+                double s = 0;
+                for (int i = j; i < m; i++)
+                    s += v_t[static_cast<size_t>(p) * m + i] * v_t[static_cast<size_t>(j) * m + i];
+                vtv[p] = s;
+            }
+            for (int p = 0; p < j; p++) {
+                double s = 0;
+                for (int q = p; q < j; q++)
+                    s += t[static_cast<size_t>(p) * kb + q] * vtv[q];
+                t[static_cast<size_t>(p) * kb + j] = -tau[j] * s;
+            }
+            t[static_cast<size_t>(j) * kb + j] = tau[j];
+        }
+    }
+
+    /// C = H^T * C if transpose, C = H * C otherwise, C of size (m, nc)
+    void apply(double *c, int nc, int ldc, bool transpose) {
+        if (nc == 0)
+            return;
+        w.assign(static_cast<size_t>(kb) * nc, 0);
+        gemm(kb, nc, m, 1, v_t.data(), m, c, ldc, 0, w.data(), nc);
+
+        // W = T^T * W or W = T * W, in place
+        std::vector<double> row(nc);
+        if (transpose) {
+            for (int i = kb - 1; i >= 0; i--) {
+                std::fill(row.begin(), row.end(), 0);
+                for (int p = 0; p <= i; p++) {
+                    double t_pi = t[static_cast<size_t>(p) * kb + i];
+                    const double *w_p = w.data() + static_cast<size_t>(p) * nc;
+                    for (int c = 0; c < nc; c++)
+                        row[c] += t_pi * w_p[c];
+                }
+                std::copy(row.begin(), row.end(), w.begin() + static_cast<size_t>(i) * nc);
+            }
+        } else {
+            for (int i = 0; i < kb; i++) {
+                std::fill(row.begin(), row.end(), 0);
+                for (int p = i; p < kb; p++) {
+                    double t_ip = t[static_cast<size_t>(i) * kb + p];
+                    const double *w_p = w.data() + static_cast<size_t>(p) * nc;
+                    for (int c = 0; c < nc; c++)
+                        row[c] += t_ip * w_p[c];
+                }
+                std::copy(row.begin(), row.end(), w.begin() + static_cast<size_t>(i) * nc);
+            }
+        }
+
+        gemm(m, nc, kb, -1, v.data(), kb, w.data(), nc, 1, c, ldc);
+    }
+};
+
+/// Blocked Householder QR factorization
+void qr_factor(double *a, int m, int n, int lda, double *tau) {
+    int k = std::min(m, n);
+    for (int k0 = 0; k0 < k; k0 += block_size) {
+        int kb = std::min(block_size, k - k0);
+        double *a_kk = a + static_cast<size_t>(k0) * lda + k0;
+        qr_panel(a_kk, m - k0, kb, lda, tau + k0);
+        if (k0 + kb < n) {
+            BlockReflector h(a_kk, m - k0, kb, lda, tau + k0);
+            h.apply(a_kk + kb, n - k0 - kb, lda, true);
+        }
+    }
+}
+
+/// Overwrite B with Q^T * B, applying the block reflectors in order
+void qr_apply_qt(const double *a, int m, int n, int lda, const double *tau, double *b, int nrhs,
+                 int ldb) {
+    int k = std::min(m, n);
+    for (int k0 = 0; k0 < k; k0 += block_size) {
+        int kb = std::min(block_size, k - k0);
+        BlockReflector h(a + static_cast<size_t>(k0) * lda + k0, m - k0, kb, lda, tau + k0);
+        h.apply(b + static_cast<size_t>(k0) * ldb, nrhs, ldb, true);
+    }
+}
+
+/// Form the first k columns of Q by applying the block reflectors to [I; 0] in reverse order
+void qr_form_q(const double *a, int m, int n, int lda, const double *tau, double *q, int k,
+               int ldq) {
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < k; j++)
+            q[static_cast<size_t>(i) * ldq + j] = (i == j) ? 1 : 0;
+    int r = std::min(m, n);
+    for (int k0 = ((r - 1) / block_size) * block_size; r > 0 && k0 >= 0; k0 -= block_size) {
+        int kb = std::min(block_size, r - k0);
+        BlockReflector h(a + static_cast<size_t>(k0) * lda + k0, m - k0, kb, lda, tau + k0);
+        h.apply(q + static_cast<size_t>(k0) * ldq, k, ldq, false);
+    }
+}
+
+/** Householder tridiagonalization
+   Step i reflects a[i][i+1:n] onto its first entry and applies the reflector from both sides to
+   the trailing block as a rank-2 update, A22 -= v * w^T + w * v^T, with the symmetric product
+   and the update split over rows in parallel.
+*/
+void tridiagonalize(double *a, int n, int lda, double *d, double *e, double *tau) {
+    std::vector<double> v(n), p(n);
+    for (int i = 0; i < n - 1; i++) {
+        double *a_i = a + static_cast<size_t>(i) * lda;
+        d[i] = a_i[i];
+        int len = n - i - 1;
+
+        double alpha = a_i[i + 1];
+        double x_norm = 0;
+        for (int j = i + 2; j < n; j++)
+            x_norm = std::hypot(x_norm, a_i[j]);
+        if (x_norm == 0) {
+            tau[i] = 0;
+            e[i] = alpha;
+            continue;
+        }
+        double beta = -std::copysign(std::hypot(alpha, x_norm), alpha);
+        tau[i] = (beta - alpha) / beta;
+        double scale = 1 / (alpha - beta);
+        v[0] = 1;
+        for (int j = 1; j < len; j++) {
+            a_i[i + 1 + j] *= scale;
+            v[j] = a_i[i + 1 + j];
+        }
+        a_i[i + 1] = beta;
+        e[i] = beta;
+
+        // p = tau * A22 * v
+        double t = tau[i];
+        int grain = std::max(16, 8192 / std::max(len, 1));
+        parallel_for(0, len, grain, [&](int r0, int r1) {
+            for (int r = r0; r < r1; r++) {
+                const double *a_r = a + static_cast<size_t>(i + 1 + r) * lda + i + 1;
+                double s = 0;
+                for (int c = 0; c < len; c++)
+                    s += a_r[c] * v[c];
+                p[r] = t * s;
+            }
+        });
+
+        // w = p - (tau / 2) * (p^T * v) * v, stored in p
+        double pv = 0;
+        for (int j = 0; j < len; j++)
+            pv += p[j] * v[j];
+        double k = 0.5 * t * pv;
+        for (int j = 0; j < len; j++)
+            p[j] -= k * v[j];
+
+        parallel_for(0, len, grain, [&](int r0, int r1) {
+            for (int r = r0; r < r1; r++) {
+                double *a_r = a + static_cast<size_t>(i + 1 + r) * lda + i + 1;
+                double v_r = v[r], w_r = p[r];
+                for (int c = 0; c < len; c++)
+                    a_r[c] -= v_r * p[c] + w_r * v[c];
+            }
+        });
+    }
+    if (n > 0) {
+        d[n - 1] = a[static_cast<size_t>(n - 1) * lda + n - 1];
+        e[n - 1] = 0;
+    }
+}
+
+/// Apply Q = H_0 * H_1 * ... * H_{n-2} to k vectors, the vectors split across threads
+void tridiagonal_back_transform(const double *a, int n, int lda, const double *tau, double *z,
+                                int k) {
+    parallel_for(0, k, 1, [&](int k0, int k1) {
+        for (int q = k0; q < k1; q++) {
+            double *z_q = z + static_cast<size_t>(q) * n;
+            for (int i = n - 2; i >= 0; i--) {
+                if (tau[i] == 0)
+                    continue;
+                const double *v = a + static_cast<size_t>(i) * lda + i + 1;
+                double s = z_q[i + 1];
+                for (int j = 1; j < n - i - 1; j++)
+                    s += v[j] * z_q[i + 1 + j];
+                s *= tau[i];
+                z_q[i + 1] -= s;
+                for (int j = 1; j < n - i - 1; j++)
+                    z_q[i + 1 + j] -= s * v[j];
+            }
+        }
+    });
+}
+
+/** Implicit QL iterations with Wilkinson-like shifts
+   An off-diagonal entry is dropped when it is negligible next to its two diagonal entries or
+   next to the norm of the Matrix, the latter so that clusters of near-zero eigenvalues of low
+   rank matrices converge. The Givens rotations of one QL sweep are recorded and then applied to
+   the vectors, with the columns of the vectors split across threads so that every thread
+   replays the whole sweep.
+*/
+bool tridiagonal_ql(double *d, double *e, int n, double *z) {
+    const double eps = std::numeric_limits<double>::epsilon();
+    double t_norm = 0;
+    for (int i = 0; i < n; i++)
+        t_norm = std::max(t_norm, std::abs(d[i]) + std::abs(e[i]));
+    std::vector<int> rot_i;
+    std::vector<double> rot_c, rot_s;
+
+    for (int l = 0; l < n; l++) {
+        int iter = 0, m;
+        do {
+            for (m = l; m < n - 1; m++) {
+                double dd = std::abs(d[m]) + std::abs(d[m + 1]);
+                if (std::abs(e[m]) <= eps * dd || std::abs(e[m]) <= eps * t_norm)
+                    break;
+            }
+            if (m == l)
+                break;
+            if (iter++ == 60)
+                return false;
+
+            double g = (d[l + 1] - d[l]) / (2 * e[l]);
+            double r = std::hypot(g, 1.0);
+            g = d[m] - d[l] + e[l] / (g + std::copysign(r, g));
+            double s = 1, c = 1, p = 0;
+            int i;
+            rot_i.clear();
+            rot_c.clear();
+            rot_s.clear();
+            for (i = m - 1; i >= l; i--) {
+                double f = s * e[i], b = c * e[i];
+                e[i + 1] = (r = std::hypot(f, g));
+                if (r == 0) {
+                    d[i + 1] -= p;
+                    e[m] = 0;
+                    break;
+                }
+                s = f / r;
+                c = g / r;
+                g = d[i + 1] - p;
+                r = (d[i] - g) * s + 2 * c * b;
+                p = s * r;
+                d[i + 1] = g + p;
+                g = c * r - b;
+                rot_i.push_back(i);
+                rot_c.push_back(c);
+                rot_s.push_back(s);
+            }
+
+            if (z != nullptr && !rot_i.empty()) {
+                int grain = std::max(64, n / (4 * num_threads()));
+                parallel_for(0, n, grain, [&](int c0, int c1) {
+                    for (size_t q = 0; q < rot_i.size(); q++) {
+                        double *z_i = z + static_cast<size_t>(rot_i[q]) * n;
+                        double *z_i1 = z_i + n;
+                        double cq = rot_c[q], sq = rot_s[q];
+                        for (int col = c0; col < c1; col++) {
+                            double f = z_i1[col];
+                            z_i1[col] = sq * z_i[col] + cq * f;
+                            z_i[col] = cq * z_i[col] - sq * f;
+                        }
+                    }
+                });
+            }
+
+            if (r == 0 && i >= l)
+                continue;
+            d[l] -= p;
+            e[l] = g;
+            e[m] = 0;
+        } while (m != l);
+    }
+    return true;
+}
+
+/** Inverse iteration on T - lambda * I, factorized once per eigenvalue
+   The tridiagonal system is factorized with partial pivoting, which adds a second
+   superdiagonal. Three iterations from a fixed start vector are enough for well separated
+   eigenvalues; vectors of clustered eigenvalues are orthogonalized with Gram-Schmidt.
+*/
+void tridiagonal_inverse_iteration(const double *d, const double *e, int n, const double *w, int k,
+                                   double *z) {
+    double t_norm = 0;
+    for (int i = 0; i < n; i++) {
+        double row = std::abs(d[i]) + std::abs(e[i]) + ((i > 0) ? std::abs(e[i - 1]) : 0);
+        t_norm = std::max(t_norm, row);
+    }
+    const double eps = std::numeric_limits<double>::epsilon();
+    double tiny = std::max(eps * t_norm, std::numeric_limits<double>::min());
+    double cluster = 1e-3 * t_norm;
+
+    std::vector<double> u0(n), u1(n), u2(n), mult(n);
+    std::vector<char> swapped(n);
+    for (int q = 0; q < k; q++) {
+        double lambda = w[q];
+        if (n == 1) {
+            z[0] = 1;
+            continue;
+        }
+
+        // Factorization of T - lambda * I with partial pivoting
+        double r0 = d[0] - lambda, r1 = e[0], r2 = 0;
+        for (int i = 0; i < n - 1; i++) {
+            double o0 = e[i], o1 = d[i + 1] - lambda, o2 = (i + 1 < n - 1) ? e[i + 1] : 0;
+            swapped[i] = std::abs(o0) > std::abs(r0);
+            if (swapped[i]) {
+                std::swap(r0, o0);
+                std::swap(r1, o1);
+                std::swap(r2, o2);
+            }
+            if (std::abs(r0) < tiny)
+                r0 = std::copysign(tiny, r0);
+            mult[i] = o0 / r0;
+            u0[i] = r0;
+            u1[i] = r1;
+            u2[i] = r2;
+            r0 = o1 - mult[i] * r1;
+            r1 = o2 - mult[i] * r2;
+            r2 = 0;
+        }
+        u0[n - 1] = (std::abs(r0) < tiny) ? std::copysign(tiny, r0) : r0;
+
+        double *x = z + static_cast<size_t>(q) * n;
+        for (int i = 0; i < n; i++)
+            x[i] = 1.0 + 0.5 * std::sin(1.0 + i);
+        for (int iter = 0; iter < 3; iter++) {
+            for (int i = 0; i < n - 1; i++) {
+                if (swapped[i])
+                    std::swap(x[i], x[i + 1]);
+                x[i + 1] -= mult[i] * x[i];
+            }
+            for (int i = n - 1; i >= 0; i--) {
+                double s = x[i];
+                if (i + 1 < n)
+                    s -= u1[i] * x[i + 1];
+                if (i + 2 < n)
+                    s -= u2[i] * x[i + 2];
+                x[i] = s / u0[i];
+            }
+
+            for (int p = 0; p < q; p++) {
+                if (std::abs(w[p] - lambda) > cluster)
+                    continue;
+                const double *x_p = z + static_cast<size_t>(p) * n;
+                double dot = 0;
+                for (int i = 0; i < n; i++)
+                    dot += x[i] * x_p[i];
+                for (int i = 0; i < n; i++)
+                    x[i] -= dot * x_p[i];
+            }
+            double norm = 0;
+            for (int i = 0; i < n; i++)
+                norm = std::hypot(norm, x[i]);
+            for (int i = 0; i < n; i++)
+                x[i] /= norm;
+        }
+    }
+}
+
+/// One-sided Jacobi orthogonalization of the rows of w
+bool jacobi_orthogonalize(double *w, int n, int m, double *v, int max_sweeps) {
+    const double eps = std::numeric_limits<double>::epsilon();
+    int players = n + (n % 2);
+    std::vector<int> order(players);
+    for (int i = 0; i < players; i++)
+        order[i] = i;
+
+    for (int sweep = 0; sweep < max_sweeps; sweep++) {
+        std::atomic<bool> rotated(false);
+        for (int round = 0; round < players - 1; round++) {
+            parallel_for(0, players / 2, 1, [&](int p0, int p1) {
+                for (int pair = p0; pair < p1; pair++) {
+                    int i = order[pair], j = order[players - 1 - pair];
+                    if (i >= n || j >= n)
+                        continue;
+                    if (i > j)
+                        std::swap(i, j);
+                    double *w_i = w + static_cast<size_t>(i) * m;
+                    double *w_j = w + static_cast<size_t>(j) * m;
+                    double alpha = 0, beta = 0, gamma = 0;
+                    for (int c = 0; c < m; c++) {
+                        alpha += w_i[c] * w_i[c];
+                        beta += w_j[c] * w_j[c];
+                        gamma += w_i[c] * w_j[c];
+                    }
+                    if (std::abs(gamma) <= eps * std::sqrt(alpha * beta) || gamma == 0)
+                        continue;
+                    rotated = true;
+
+                    double zeta = (beta - alpha) / (2 * gamma);
+                    double t = std::copysign(1.0, zeta) / (std::abs(zeta) + std::hypot(1.0, zeta));
+                    double c = 1 / std::hypot(1.0, t), s = c * t;
+                    for (int q = 0; q < m; q++) {
+                        double x = w_i[q], y = w_j[q];
+                        w_i[q] = c * x - s * y;
+                        w_j[q] = s * x + c * y;
+                    }
+                    double *v_i = v + static_cast<size_t>(i) * n;
+                    double *v_j = v + static_cast<size_t>(j) * n;
+                    for (int q = 0; q < n; q++) {
+                        double x = v_i[q], y = v_j[q];
+                        v_i[q] = c * x - s * y;
+                        v_j[q] = s * x + c * y;
+                    }
+                }
+            });
+            // Round-robin: keep the first player fixed and rotate the others
+            std::rotate(order.begin() + 1, order.end() - 1, order.end());
+        }
+        if (!rotated)
+            return true;
+    }
+    return false;
+}
+
+} // namespace kernels
@@ -0,0 +1,168 @@
+#ifndef _matrix_kernels_hpp_
+#define _matrix_kernels_hpp_
+
+#include <matrix_basic.hpp>
+
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <queue>
+#include <thread>
+
+/** Dense kernels working on contiguous row-major buffers
+   These are the building blocks used by the MatrixOp linear algebra methods. A matrix of
+   size (m, n) with leading dimension ld stores element (i, j) at a[i * ld + j].
+*/
+namespace kernels {
+
+/// Block size used by the blocked factorizations and triangular solves
+const int block_size = 64;
+
+/** Pool of worker threads shared by all parallel kernels
+   Workers are started on demand, up to the number of threads set with set_num_threads() minus
+   the calling thread, which always takes part in the work it submits.
+*/
+class ThreadPool {
+  private:
+    std::vector<std::thread> workers;
+    std::queue<std::function<void()>> tasks;
+    std::mutex mutex;
+    std::condition_variable cv;
+    bool stop = false;
+
+  public:
+    ~ThreadPool();
+    void reserve(int);
+    void submit(std::function<void()>);
+    static ThreadPool &instance();
+};
+
+/// Method to get the number of threads used by the parallel kernels
+int num_threads();
+
+/// Method to set the number of threads used by the parallel kernels
+void set_num_threads(int);
+
+/** Method to run fn(chunk_begin, chunk_end) over [begin, end) split in chunks of at least grain
+   The calling thread works on chunks too, so parallel_for can be called from inside a task.
+   Calls made from inside another parallel_for run serially.
+*/
+void parallel_for(int begin, int end, int grain, const std::function<void(int, int)> &fn);
+
+/// Same as parallel_for, with at most threads threads instead of the number set globally
+void parallel_for(int begin, int end, int grain, int threads,
+                  const std::function<void(int, int)> &fn);
+
+/// Method to copy the double values of a Matrix object into a contiguous row-major buffer
+std::vector<double> pack(const Matrix &);
+
+/// Method to build a Matrix object from a contiguous row-major buffer
+Matrix unpack(const std::vector<double> &, int, int);
+
+/** Method to parse a whole cell of text as a double with std::from_chars
+   Surrounding spaces and a leading '+' are allowed. Returns false if anything else is left.
+*/
+bool parse_double(const char *begin, const char *end, double &value);
+
+/// Longest text written by format_double()
+const int double_chars = 24;
+
+/** Method to write the shortest text that parses back to value and return the end of it
+   The text is written with std::to_chars and takes at most double_chars bytes.
+*/
+char *format_double(char *p, double value);
+
+/// C = alpha * A * B + beta * C, where A is (m, k), B is (k, n) and C is (m, n)
+void gemm_serial(int m, int n, int k, double alpha, const double *a, int lda, const double *b,
+                 int ldb, double beta, double *c, int ldc);
+
+/// Same as gemm_serial, with the rows of C split across threads when the product is large
+void gemm(int m, int n, int k, double alpha, const double *a, int lda, const double *b, int ldb,
+          double beta, double *c, int ldc);
+
+/** Blocked LU factorization with partial pivoting, done in place: P * A = L * U
+   L has a unit diagonal and is stored below the diagonal, U on and above it. piv[i] is the
+   row swapped with row i at step i. Returns true if a pivot is not larger than the
+   singularity tolerance (n * epsilon * max|a_ij|).
+*/
+bool lu_factor(double *a, int n, int lda, int *piv, int &sign);
+
+/// Apply the row swaps recorded by lu_factor to a (n, nrhs) right hand side
+void lu_permute(const int *piv, int n, double *b, int nrhs, int ldb);
+
+/** Single precision version of lu_factor, done in place
+   Returns true if a pivot is zero or the factors overflowed.
+*/
+bool lu_factor_float(float *a, int n, int lda, int *piv);
+
+/// Solve A * X = B in place for a (n, nrhs) B, using the output of lu_factor_float
+void lu_solve_float(const float *lu, int n, int lda, const int *piv, float *b, int nrhs, int ldb);
+
+/// Solve L * X = B in place, L unit lower triangular of size (n, n), B of size (n, nrhs)
+void trsm_lower_unit(const double *l, int n, int ldl, double *b, int nrhs, int ldb);
+
+/// Solve U * X = B in place, U upper triangular of size (n, n), B of size (n, nrhs)
+void trsm_upper(const double *u, int n, int ldu, double *b, int nrhs, int ldb);
+
+/** Blocked Cholesky factorization A = L * L^T, done in place on the lower triangle
+   The strict upper triangle is set to zero. Returns false if the Matrix is not positive
+   definite, in which case a is left partially factorized.
+*/
+bool cholesky_factor(double *a, int n, int lda);
+
+/// Solve L * X = B in place, L lower triangular with a general diagonal
+void trsm_lower(const double *l, int n, int ldl, double *b, int nrhs, int ldb);
+
+/// Solve L^T * X = B in place, L lower triangular with a general diagonal
+void trsm_lower_trans(const double *l, int n, int ldl, double *b, int nrhs, int ldb);
+
+/** Blocked Householder QR factorization A = Q * R, done in place
+   R is stored on and above the diagonal, the Householder vectors below it with an implicit unit
+   leading entry, and tau holds the min(m, n) reflector scalars. Each panel of block_size
+   reflectors is applied to the trailing columns at once in the compact WY form
+   I - V * T * V^T, so the O(m * n^2) work runs in gemm.
+*/
+void qr_factor(double *a, int m, int n, int lda, double *tau);
+
+/// Overwrite the (m, nrhs) Matrix B with Q^T * B, using the output of qr_factor
+void qr_apply_qt(const double *a, int m, int n, int lda, const double *tau, double *b, int nrhs,
+                 int ldb);
+
+/// Form the first k columns of Q, (m, k) with leading dimension ldq, using the output of qr_factor
+void qr_form_q(const double *a, int m, int n, int lda, const double *tau, double *q, int k,
+               int ldq);
+
+/** Householder reduction of a symmetric (n, n) Matrix to tridiagonal form T = Q^T * A * Q
+   d gets the diagonal of T and e[0:n-1] its off-diagonal. The Householder vector of step i is
+   left in a[i][i+2:n] with an implicit unit entry at i+1, and its scalar in tau[i].
+*/
+void tridiagonalize(double *a, int n, int lda, double *d, double *e, double *tau);
+
+/// Overwrite the k vectors stored as rows of z (length n) with Q * z, Q from tridiagonalize
+void tridiagonal_back_transform(const double *a, int n, int lda, const double *tau, double *z,
+                                int k);
+
+/** Implicit QL iterations on a symmetric tridiagonal Matrix
+   d is overwritten with the eigenvalues (unsorted) and e is destroyed. If z is not null, the
+   rotations are also applied to the n rows of z, which hold vectors of length n, so that rows
+   of the identity become the eigenvectors. Returns false if an eigenvalue did not converge.
+*/
+bool tridiagonal_ql(double *d, double *e, int n, double *z);
+
+/** Inverse iteration for the eigenvectors of a symmetric tridiagonal Matrix
+   For every one of the k eigenvalues in w, the matching unit eigenvector is written to row i of
+   z (length n). Vectors of close eigenvalues are orthogonalized against each other.
+*/
+void tridiagonal_inverse_iteration(const double *d, const double *e, int n, const double *w, int k,
+                                   double *z);
+
+/** One-sided Jacobi orthogonalization of n vectors of length m stored as the rows of w
+   The same rotations are applied to the n rows of v (length n). Pairs of rows are visited in a
+   round-robin order so that every round is a set of independent rotations run in parallel.
+   Returns false if the rows were not orthogonal after max_sweeps sweeps.
+*/
+bool jacobi_orthogonalize(double *w, int n, int m, double *v, int max_sweeps);
+
+} // namespace kernels
+
+#endif /* _matrix_kernels_hpp_ */
@@ -0,0 +1,1122 @@
+#include <matrix_kernels.hpp>
+#include <matrix_operations.hpp>
+
+#include <limits>
+#include <random>
+
+/// Method to return the unit lower triangular factor L
+Matrix LU::L() {
+    std::vector<double> l(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < i; j++)
+            l[static_cast<size_t>(i) * n + j] = lu[static_cast<size_t>(i) * n + j];
+        l[static_cast<size_t>(i) * n + i] = 1;
+    }
+    return kernels::unpack(l, n, n);
+}
+
+/// Method to return the upper triangular factor U
+Matrix LU::U() {
+    std::vector<double> u(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; i++)
+        for (int j = i; j < n; j++)
+            u[static_cast<size_t>(i) * n + j] = lu[static_cast<size_t>(i) * n + j];
+    return kernels::unpack(u, n, n);
+}
+
+/** Method to solve A * X = B using the factorization
+   B can have any number of columns, each one is a right hand side. The triangular solves are
+   blocked so that most of the work runs in gemm.
+*/
+Matrix LU::solve(Matrix B) {
+    bool error = B.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (B.row_length() != n)
+        assert(("The Matrix objects should be of compatible dimensions", false));
+    if (singular)
+        assert(("The Matrix is singular", false));
+
+    int nrhs = B.col_length();
+    std::vector<double> x = kernels::pack(B);
+    kernels::lu_permute(piv.data(), n, x.data(), nrhs, nrhs);
+    kernels::trsm_lower_unit(lu.data(), n, n, x.data(), nrhs, nrhs);
+    kernels::trsm_upper(lu.data(), n, n, x.data(), nrhs, nrhs);
+    return kernels::unpack(x, n, nrhs);
+}
+
+/// Method to calculate the Determinant from the diagonal of U
+double LU::determinant() {
+    double D = sign;
+    for (int i = 0; i < n; i++)
+        D *= lu[static_cast<size_t>(i) * n + i];
+    return D;
+}
+
+/// Method to calculate the natural logarithm of the Determinant, NaN if it is negative
+double LU::logdet() {
+    double result = 0;
+    int det_sign = sign;
+    for (int i = 0; i < n; i++) {
+        double u_ii = lu[static_cast<size_t>(i) * n + i];
+        result += std::log(std::abs(u_ii));
+        if (u_ii < 0)
+            det_sign = -det_sign;
+    }
+    return (det_sign < 0) ? std::numeric_limits<double>::quiet_NaN() : result;
+}
+
+/// Method to calculate the Inverse by solving against the identity
+Matrix LU::inverse() {
+    if (singular)
+        assert(("The Matrix is singular", false));
+
+    std::vector<double> inv(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; i++)
+        inv[static_cast<size_t>(i) * n + i] = 1;
+    kernels::lu_permute(piv.data(), n, inv.data(), n, n);
+    kernels::trsm_lower_unit(lu.data(), n, n, inv.data(), n, n);
+    kernels::trsm_upper(lu.data(), n, n, inv.data(), n, n);
+    return kernels::unpack(inv, n, n);
+}
+
+/// Method to return the lower triangular factor L
+Matrix Cholesky::L() {
+    if (!positive_definite)
+        assert(("The Matrix is not positive definite", false));
+    return kernels::unpack(l, n, n);
+}
+
+/// Method to solve A * X = B using the factorization, or the LU fallback
+Matrix Cholesky::solve(Matrix B) {
+    if (!positive_definite)
+        return lu.solve(B);
+
+    bool error = B.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (B.row_length() != n)
+        assert(("The Matrix objects should be of compatible dimensions", false));
+
+    int nrhs = B.col_length();
+    std::vector<double> x = kernels::pack(B);
+    kernels::trsm_lower(l.data(), n, n, x.data(), nrhs, nrhs);
+    kernels::trsm_lower_trans(l.data(), n, n, x.data(), nrhs, nrhs);
+    return kernels::unpack(x, n, nrhs);
+}
+
+/** Method to calculate the natural logarithm of the Determinant
+   For a positive definite Matrix this is 2 * sum(log(l_ii)), which does not overflow like the
+   Determinant itself.
+*/
+double Cholesky::logdet() {
+    if (!positive_definite)
+        return lu.logdet();
+
+    double result = 0;
+    for (int i = 0; i < n; i++)
+        result += std::log(l[static_cast<size_t>(i) * n + i]);
+    return 2 * result;
+}
+
+/// Method to return the thin orthogonal factor Q of size (rows, min(rows, cols))
+Matrix QR::Q() {
+    int k = std::min(rows, cols);
+    std::vector<double> q(static_cast<size_t>(rows) * k);
+    kernels::qr_form_q(qr.data(), rows, cols, cols, tau.data(), q.data(), k, k);
+    return kernels::unpack(q, rows, k);
+}
+
+/// Method to return the upper triangular factor R of size (min(rows, cols), cols)
+Matrix QR::R() {
+    int k = std::min(rows, cols);
+    std::vector<double> r(static_cast<size_t>(k) * cols, 0);
+    for (int i = 0; i < k; i++)
+        for (int j = i; j < cols; j++)
+            r[static_cast<size_t>(i) * cols + j] = qr[static_cast<size_t>(i) * cols + j];
+    return kernels::unpack(r, k, cols);
+}
+
+/** Method to calculate the LU factorization of a square Matrix
+   The Matrix is singular when a pivot is not larger than n * epsilon * max|a_ij|.
+*/
+LU MatrixOp::lu(Matrix mat) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (mat.row_length() != mat.col_length())
+        assert(("The Matrix must be a square matrix", false));
+
+    LU result;
+    result.n = mat.row_length();
+    result.lu = kernels::pack(mat);
+    result.piv.resize(result.n);
+    result.singular =
+        kernels::lu_factor(result.lu.data(), result.n, result.n, result.piv.data(), result.sign);
+    return result;
+}
+
+/// Method to calculate the Determinant of a Matrix using its LU factorization
+double MatrixOp::determinant(Matrix mat, int n) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (mat.row_length() != mat.col_length())
+        assert(("The Matrix must be a square matrix", false));
+
+    if (n != mat.row_length())
+        mat = mat.slice(0, n, 0, n);
+    return lu(mat).determinant();
+}
+
+/// Method to calculate the Inverse of a Matrix using its LU factorization
+Matrix MatrixOp::inverse(Matrix mat) { return lu(mat).inverse(); }
+
+/** Method to calculate the Cholesky factorization of a symmetric positive definite Matrix
+   It needs half the flops of lu(). If the Matrix is not positive definite the returned object
+   reports it through positive_definite and falls back to the LU factorization.
+*/
+Cholesky MatrixOp::cholesky(Matrix mat) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (mat.row_length() != mat.col_length())
+        assert(("The Matrix must be a square matrix", false));
+
+    Cholesky result;
+    result.n = mat.row_length();
+    result.l = kernels::pack(mat);
+    result.positive_definite = kernels::cholesky_factor(result.l.data(), result.n, result.n);
+    if (!result.positive_definite) {
+        result.l.clear();
+        result.lu = lu(mat);
+    }
+    return result;
+}
+
+/// Method to solve A * X = B from the Cholesky factorization of A
+Matrix MatrixOp::cho_solve(Cholesky factors, Matrix B) { return factors.solve(B); }
+
+/// Method to calculate the natural logarithm of the Determinant of a Matrix
+double MatrixOp::logdet(Matrix mat) { return cholesky(mat).logdet(); }
+
+/// Method to calculate the Householder QR factorization of a Matrix
+QR MatrixOp::qr(Matrix mat) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    QR result;
+    result.rows = mat.row_length();
+    result.cols = mat.col_length();
+    result.qr = kernels::pack(mat);
+    result.tau.resize(std::min(result.rows, result.cols));
+    kernels::qr_factor(result.qr.data(), result.rows, result.cols, result.cols, result.tau.data());
+    return result;
+}
+
+/** Method to calculate the R factor of the QR factorization of a tall (m, n) buffer with TSQR
+   The rows are split in one block per thread, every block is factorized independently and the
+   stacked R factors of the blocks are factorized once more. Returns the (n, n) upper triangle.
+*/
+static std::vector<double> tsqr_r(std::vector<double> &a, int m, int n, int blocks) {
+    int block_rows = (m + blocks - 1) / blocks;
+    std::vector<double> stacked(static_cast<size_t>(blocks) * n * n, 0);
+    kernels::parallel_for(0, blocks, 1, [&](int b0, int b1) {
+        for (int b = b0; b < b1; b++) {
+            int r0 = b * block_rows, r1 = std::min(r0 + block_rows, m);
+            if (r1 <= r0)
+                continue;
+            double *a_b = a.data() + static_cast<size_t>(r0) * n;
+            std::vector<double> tau(std::min(r1 - r0, n));
+            kernels::qr_factor(a_b, r1 - r0, n, n, tau.data());
+            for (int i = 0; i < std::min(r1 - r0, n); i++)
+                for (int j = i; j < n; j++)
+                    stacked[(static_cast<size_t>(b) * n + i) * n + j] =
+                        a_b[static_cast<size_t>(i) * n + j];
+        }
+    });
+
+    std::vector<double> tau(n);
+    kernels::qr_factor(stacked.data(), blocks * n, n, n, tau.data());
+    stacked.resize(static_cast<size_t>(n) * n);
+    return stacked;
+}
+
+/** Method to solve the linear least squares problem min ||X * coef - y||
+   X must have at least as many rows as columns and full column rank. The QR factorization of
+   [X y] gives R and Q^T * y at once, so coef comes from one triangular solve and the residuals
+   from the rows of Q^T * y below R. Tall-skinny problems use TSQR to factorize row blocks in
+   parallel.
+*/
+Lstsq MatrixOp::lstsq(Matrix X, Matrix y) {
+    bool error = (X.if_double) && (y.if_double);
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    int m = X.row_length(), n = X.col_length(), k = y.col_length();
+    if (y.row_length() != m)
+        assert(("The Matrix objects should be of compatible dimensions", false));
+    if (m < n)
+        assert(("The Matrix must have at least as many rows as columns", false));
+
+    int na = n + k;
+    std::vector<double> a(static_cast<size_t>(m) * na);
+    for (int i = 0; i < m; i++) {
+        std::copy(X.double_mat[i].begin(), X.double_mat[i].end(),
+                  a.begin() + static_cast<size_t>(i) * na);
+        std::copy(y.double_mat[i].begin(), y.double_mat[i].end(),
+                  a.begin() + static_cast<size_t>(i) * na + n);
+    }
+
+    int r_rows = std::min(m, na);
+    int blocks = std::min(kernels::num_threads(), m / (4 * na));
+    std::vector<double> r;
+    if (blocks > 1) {
+        r = tsqr_r(a, m, na, blocks);
+    } else {
+        std::vector<double> tau(r_rows);
+        kernels::qr_factor(a.data(), m, na, na, tau.data());
+        r.assign(a.begin(), a.begin() + static_cast<size_t>(r_rows) * na);
+    }
+
+    double max_diag = 0;
+    for (int i = 0; i < n; i++)
+        max_diag = std::max(max_diag, std::abs(r[static_cast<size_t>(i) * na + i]));
+    double tol = m * std::numeric_limits<double>::epsilon() * max_diag;
+    for (int i = 0; i < n; i++)
+        if (std::abs(r[static_cast<size_t>(i) * na + i]) <= tol)
+            assert(("The Matrix is rank deficient", false));
+
+    std::vector<double> coef(static_cast<size_t>(n) * k);
+    for (int i = 0; i < n; i++) {
+        const double *r_i = r.data() + static_cast<size_t>(i) * na;
+        std::copy(r_i + n, r_i + na, coef.begin() + static_cast<size_t>(i) * k);
+    }
+    kernels::trsm_upper(r.data(), n, na, coef.data(), k, k);
+
+    std::vector<double> residuals(k, 0);
+    for (int i = n; i < r_rows; i++) {
+        const double *r_i = r.data() + static_cast<size_t>(i) * na;
+        for (int j = i - n; j < k; j++)
+            residuals[j] += r_i[n + j] * r_i[n + j];
+    }
+
+    Lstsq result;
+    result.coef = kernels::unpack(coef, n, k);
+    result.residuals = kernels::unpack(residuals, 1, k);
+    return result;
+}
+
+/** Method to calculate the k largest eigenpairs of a symmetric (n, n) buffer
+   The buffer is reduced to tridiagonal form. For the full spectrum the QL iterations also
+   rotate the eigenvectors; for k < n only the eigenvalues are iterated and the k eigenvectors
+   come from inverse iteration, which is O(n * k) instead of O(n^3). The vectors are written as
+   the rows of vectors, in descending order of their eigenvalue.
+*/
+static void eigh_buffer(std::vector<double> &a, int n, int k, std::vector<double> &values,
+                        std::vector<double> &vectors) {
+    std::vector<double> d(n), e(n), tau(n);
+    kernels::tridiagonalize(a.data(), n, n, d.data(), e.data(), tau.data());
+
+    std::vector<double> w = d, e_work = e;
+    std::vector<double> z;
+    if (k == n) {
+        z.assign(static_cast<size_t>(n) * n, 0);
+        for (int i = 0; i < n; i++)
+            z[static_cast<size_t>(i) * n + i] = 1;
+    }
+    double *vectors_z = z.empty() ? nullptr : z.data();
+    if (!kernels::tridiagonal_ql(w.data(), e_work.data(), n, vectors_z))
+        assert(("The eigenvalues did not converge", false));
+
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int i, int j) { return w[i] > w[j]; });
+
+    values.resize(k);
+    for (int j = 0; j < k; j++)
+        values[j] = w[order[j]];
+    vectors.resize(static_cast<size_t>(k) * n);
+    if (k == n) {
+        for (int j = 0; j < k; j++)
+            std::copy(z.begin() + static_cast<size_t>(order[j]) * n,
+                      z.begin() + static_cast<size_t>(order[j] + 1) * n,
+                      vectors.begin() + static_cast<size_t>(j) * n);
+    } else {
+        kernels::tridiagonal_inverse_iteration(d.data(), e.data(), n, values.data(), k,
+                                               vectors.data());
+    }
+    kernels::tridiagonal_back_transform(a.data(), n, n, tau.data(), vectors.data(), k);
+}
+
+/// Method to calculate the eigenvalues and eigenvectors of a symmetric Matrix
+Eigh MatrixOp::eigh(Matrix mat) { return eigh(mat, mat.row_length()); }
+
+/** Method to calculate the k largest eigenvalues and their eigenvectors of a symmetric Matrix
+   The Matrix must be symmetric, which is not checked. The reduction reads the first row and the
+   whole block below and right of it, so both triangles are used and a Matrix that is not
+   symmetric gives meaningless results; only the first column below the diagonal is never read.
+*/
+Eigh MatrixOp::eigh(Matrix mat, int k) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (mat.row_length() != mat.col_length())
+        assert(("The Matrix must be a square matrix", false));
+
+    int n = mat.row_length();
+    if (k < 1 || k > n)
+        assert(("The number of eigenvalues is out of range", false));
+
+    std::vector<double> a = kernels::pack(mat);
+    std::vector<double> values, vectors;
+    eigh_buffer(a, n, k, values, vectors);
+
+    std::vector<double> columns(static_cast<size_t>(n) * k);
+    for (int j = 0; j < k; j++)
+        for (int i = 0; i < n; i++)
+            columns[static_cast<size_t>(i) * k + j] = vectors[static_cast<size_t>(j) * n + i];
+
+    Eigh result;
+    result.values = kernels::unpack(values, 1, k);
+    result.vectors = kernels::unpack(columns, n, k);
+    return result;
+}
+
+/** Method to transpose a (rows, cols) row-major buffer
+   Blocks of 32 x 32 are transposed at a time so that both the reads and the writes stay in
+   cache.
+*/
+static std::vector<double> transpose_buffer(const std::vector<double> &a, int rows, int cols) {
+    std::vector<double> t(a.size());
+    for (int i0 = 0; i0 < rows; i0 += 32)
+        for (int j0 = 0; j0 < cols; j0 += 32)
+            for (int i = i0; i < std::min(i0 + 32, rows); i++)
+                for (int j = j0; j < std::min(j0 + 32, cols); j++)
+                    t[static_cast<size_t>(j) * rows + i] = a[static_cast<size_t>(i) * cols + j];
+    return t;
+}
+
+/** Method to calculate the thin SVD of a (m, n) buffer with m >= n
+   Tall inputs are first reduced to their (n, n) R factor. The columns of R are then
+   orthogonalized with one-sided Jacobi rotations, so the singular values are the norms of the
+   rotated columns and the rotations themselves accumulate into V.
+*/
+static void svd_buffer(std::vector<double> &a, int m, int n, std::vector<double> &u,
+                       std::vector<double> &s, std::vector<double> &v) {
+    std::vector<double> q, w;
+    if (m > n) {
+        std::vector<double> tau(n);
+        kernels::qr_factor(a.data(), m, n, n, tau.data());
+        q.resize(static_cast<size_t>(m) * n);
+        kernels::qr_form_q(a.data(), m, n, n, tau.data(), q.data(), n, n);
+        w.assign(static_cast<size_t>(n) * n, 0);
+        for (int i = 0; i < n; i++)
+            for (int j = i; j < n; j++)
+                w[static_cast<size_t>(j) * n + i] = a[static_cast<size_t>(i) * n + j];
+    } else {
+        w = transpose_buffer(a, n, n);
+    }
+
+    std::vector<double> v_rows(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; i++)
+        v_rows[static_cast<size_t>(i) * n + i] = 1;
+    if (!kernels::jacobi_orthogonalize(w.data(), n, n, v_rows.data(), 60))
+        assert(("The singular values did not converge", false));
+
+    std::vector<double> norms(n);
+    for (int j = 0; j < n; j++) {
+        double norm = 0;
+        for (int i = 0; i < n; i++)
+            norm = std::hypot(norm, w[static_cast<size_t>(j) * n + i]);
+        norms[j] = norm;
+    }
+    std::vector<int> order(n);
+    for (int i = 0; i < n; i++)
+        order[i] = i;
+    std::sort(order.begin(), order.end(), [&](int i, int j) { return norms[i] > norms[j]; });
+
+    s.resize(n);
+    std::vector<double> u_r(static_cast<size_t>(n) * n, 0);
+    v.assign(static_cast<size_t>(n) * n, 0);
+    for (int j = 0; j < n; j++) {
+        int o = order[j];
+        s[j] = norms[o];
+        double inv = (norms[o] > 0) ? 1 / norms[o] : 0;
+        for (int i = 0; i < n; i++) {
+            u_r[static_cast<size_t>(i) * n + j] = w[static_cast<size_t>(o) * n + i] * inv;
+            v[static_cast<size_t>(i) * n + j] = v_rows[static_cast<size_t>(o) * n + i];
+        }
+    }
+
+    if (m > n) {
+        u.assign(static_cast<size_t>(m) * n, 0);
+        kernels::gemm(m, n, n, 1, q.data(), n, u_r.data(), n, 0, u.data(), n);
+    } else {
+        u = u_r;
+    }
+}
+
+/// Method to calculate the thin singular value decomposition of a Matrix
+SVD MatrixOp::svd(Matrix mat) {
+    return svd(mat, std::min(mat.row_length(), mat.col_length()));
+}
+
+/** Method to calculate the k largest singular values and their singular vectors
+   With k smaller than min(m, n), the top k eigenpairs of the smaller Gram Matrix (A^T * A or
+   A * A^T) are computed instead of the full decomposition, and the other set of singular
+   vectors is recovered with one gemm. This squares the condition number, which is fine for the
+   leading singular values but not for the trailing ones.
+*/
+SVD MatrixOp::svd(Matrix mat, int k) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    int m = mat.row_length(), n = mat.col_length();
+    int r = std::min(m, n);
+    if (k < 1 || k > r)
+        assert(("The number of singular values is out of range", false));
+
+    std::vector<double> a = kernels::pack(mat);
+    bool tall = (m >= n);
+    if (!tall) {
+        a = transpose_buffer(a, m, n);
+        std::swap(m, n);
+    }
+
+    std::vector<double> u, s, v;
+    if (k == r) {
+        svd_buffer(a, m, n, u, s, v);
+    } else {
+        std::vector<double> a_t = transpose_buffer(a, m, n);
+        std::vector<double> gram(static_cast<size_t>(n) * n);
+        kernels::gemm(n, n, m, 1, a_t.data(), m, a.data(), n, 0, gram.data(), n);
+
+        std::vector<double> values, v_rows;
+        eigh_buffer(gram, n, k, values, v_rows);
+        s.resize(k);
+        v.resize(static_cast<size_t>(n) * k);
+        for (int j = 0; j < k; j++) {
+            s[j] = std::sqrt(std::max(values[j], 0.0));
+            for (int i = 0; i < n; i++)
+                v[static_cast<size_t>(i) * k + j] = v_rows[static_cast<size_t>(j) * n + i];
+        }
+        u.assign(static_cast<size_t>(m) * k, 0);
+        kernels::gemm(m, k, n, 1, a.data(), n, v.data(), k, 0, u.data(), k);
+        for (int i = 0; i < m; i++)
+            for (int j = 0; j < k; j++)
+                u[static_cast<size_t>(i) * k + j] *= (s[j] > 0) ? 1 / s[j] : 0;
+    }
+
+    SVD result;
+    result.S = kernels::unpack(s, 1, k);
+    if (tall) {
+        result.U = kernels::unpack(u, m, k);
+        result.V = kernels::unpack(v, n, k);
+    } else {
+        result.U = kernels::unpack(v, n, k);
+        result.V = kernels::unpack(u, m, k);
+    }
+    return result;
+}
+
+/// Method to replace a (m, l) buffer with m >= l by an orthonormal basis of its columns
+static void orthonormalize(std::vector<double> &y, int m, int l) {
+    std::vector<double> tau(l), q(static_cast<size_t>(m) * l);
+    kernels::qr_factor(y.data(), m, l, l, tau.data());
+    kernels::qr_form_q(y.data(), m, l, l, tau.data(), q.data(), l, l);
+    y.swap(q);
+}
+
+/// Method to calculate a truncated SVD with a random sketch, using the seed 0
+SVD MatrixOp::randomized_svd(Matrix mat, int k, int oversample, int power_iters) {
+    return randomized_svd(mat, k, oversample, power_iters, 0);
+}
+
+/** Method to calculate the k largest singular values and vectors with a random sketch
+   The range of A is sampled with a Gaussian (n, k + oversample) test Matrix and orthonormalized
+   into Q, with power_iters rounds of A * A^T in between to sharpen a slowly decaying spectrum.
+   The small Matrix Q^T * A is then decomposed exactly. All the O(m * n) work is done by gemm,
+   and A is never transposed. The same seed always gives the same result.
+*/
+SVD MatrixOp::randomized_svd(Matrix mat, int k, int oversample, int power_iters,
+                             unsigned int seed) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    int m = mat.row_length(), n = mat.col_length();
+    if (k < 1 || k > std::min(m, n))
+        assert(("The number of singular values is out of range", false));
+    if (oversample < 0 || power_iters < 0)
+        assert(("The oversampling and the number of power iterations must not be negative",
+                false));
+    int l = std::min(k + oversample, std::min(m, n));
+
+    std::vector<double> a = kernels::pack(mat);
+    std::vector<double> omega(static_cast<size_t>(n) * l);
+    std::mt19937 generator(seed);
+    std::normal_distribution<double> normal(0, 1);
+    for (double &x : omega)
+        x = normal(generator);
+
+    // Y = A * omega, then Y = A * (A^T * Q) for every power iteration
+    std::vector<double> y(static_cast<size_t>(m) * l), z(static_cast<size_t>(l) * n);
+    kernels::gemm(m, l, n, 1, a.data(), n, omega.data(), l, 0, y.data(), l);
+    orthonormalize(y, m, l);
+    for (int it = 0; it < power_iters; it++) {
+        std::vector<double> q_t = transpose_buffer(y, m, l);
+        kernels::gemm(l, n, m, 1, q_t.data(), m, a.data(), n, 0, z.data(), n);
+        std::vector<double> z_t = transpose_buffer(z, l, n);
+        orthonormalize(z_t, n, l);
+        kernels::gemm(m, l, n, 1, a.data(), n, z_t.data(), l, 0, y.data(), l);
+        orthonormalize(y, m, l);
+    }
+
+    // B = Q^T * A is (l, n), decomposed through its transpose B^T = U_b * S * V_b^T
+    std::vector<double> q_t = transpose_buffer(y, m, l);
+    kernels::gemm(l, n, m, 1, q_t.data(), m, a.data(), n, 0, z.data(), n);
+    std::vector<double> b_t = transpose_buffer(z, l, n);
+    std::vector<double> u_b, s, v_b;
+    svd_buffer(b_t, n, l, u_b, s, v_b);
+
+    // U = Q * V_b and V = U_b, keeping the first k columns
+    std::vector<double> v_k(static_cast<size_t>(l) * k), u(static_cast<size_t>(m) * k);
+    std::vector<double> v(static_cast<size_t>(n) * k);
+    for (int i = 0; i < l; i++)
+        std::copy(v_b.begin() + static_cast<size_t>(i) * l,
+                  v_b.begin() + static_cast<size_t>(i) * l + k,
+                  v_k.begin() + static_cast<size_t>(i) * k);
+    for (int i = 0; i < n; i++)
+        std::copy(u_b.begin() + static_cast<size_t>(i) * l,
+                  u_b.begin() + static_cast<size_t>(i) * l + k,
+                  v.begin() + static_cast<size_t>(i) * k);
+    kernels::gemm(m, k, l, 1, y.data(), l, v_k.data(), k, 0, u.data(), k);
+    s.resize(k);
+
+    SVD result;
+    result.U = kernels::unpack(u, m, k);
+    result.S = kernels::unpack(s, 1, k);
+    result.V = kernels::unpack(v, n, k);
+    return result;
+}
+
+/** Method to calculate the k largest eigenpairs of a symmetric operator of size n
+   Thick restart Lanczos, which keeps the same Ritz vectors as implicitly restarted Lanczos
+   without the implicit QR shifts: a basis of m vectors is built, the wanted Ritz pairs of the
+   projected (m, m) Matrix are checked, and the basis is restarted from the p best Ritz vectors
+   and the last residual direction. Every new vector is orthogonalized twice against the whole
+   basis with gemm, so the basis stays orthonormal in floating point. The eigenvectors are
+   written as the rows of vectors, in descending order of their eigenvalue.
+*/
+static void lanczos(const LinearOperator &apply, int n, int k, std::vector<double> &values,
+                    std::vector<double> &vectors) {
+    const int max_restarts = 1000;
+    const double tol = 1e-10;
+    int m = std::min(n, std::max(2 * k + 1, k + 20));
+
+    // Rows 0..m-1 of v are the basis, row m is the next Lanczos vector
+    std::vector<double> v(static_cast<size_t>(m + 1) * n), t(static_cast<size_t>(m) * m, 0);
+    std::vector<double> w(n), h(m + 1), c(m + 1), theta, s;
+    auto row = [&](int i) { return v.data() + static_cast<size_t>(i) * n; };
+    auto norm = [&](const double *x) {
+        double sum = 0;
+        for (int i = 0; i < n; i++)
+            sum += x[i] * x[i];
+        return std::sqrt(sum);
+    };
+    // x -= V_j * (V_j^T * x) twice, with the coefficients summed in h
+    auto orthogonalize = [&](double *x, int j) {
+        std::fill(h.begin(), h.begin() + j, 0);
+        for (int pass = 0; pass < 2 && j > 0; pass++) {
+            kernels::gemm(j, 1, n, 1, v.data(), n, x, 1, 0, c.data(), 1);
+            kernels::gemm(1, n, j, -1, c.data(), j, v.data(), n, 1, x, n);
+            for (int i = 0; i < j; i++)
+                h[i] += c[i];
+        }
+        return norm(x);
+    };
+    // Row j becomes a random unit vector orthogonal to rows 0..j-1
+    std::mt19937 generator(0);
+    std::normal_distribution<double> normal(0, 1);
+    auto random_vector = [&](int j) {
+        double x_norm = 0;
+        while (x_norm == 0) {
+            for (int i = 0; i < n; i++)
+                row(j)[i] = normal(generator);
+            x_norm = orthogonalize(row(j), j);
+        }
+        for (int i = 0; i < n; i++)
+            row(j)[i] /= x_norm;
+    };
+
+    random_vector(0);
+    int l = 0;
+    double beta = 0;
+    for (int restart = 0;; restart++) {
+        for (int j = l; j < m; j++) {
+            apply(row(j), w.data());
+            double w_norm = norm(w.data());
+            beta = orthogonalize(w.data(), j + 1);
+            for (int i = 0; i <= j; i++) {
+                t[static_cast<size_t>(i) * m + j] = h[i];
+                t[static_cast<size_t>(j) * m + i] = h[i];
+            }
+            if (beta <= n * std::numeric_limits<double>::epsilon() * w_norm) {
+                // Invariant subspace found, continue with a new direction
+                beta = 0;
+                if (j + 1 < n)
+                    random_vector(j + 1);
+            } else {
+                for (int i = 0; i < n; i++)
+                    row(j + 1)[i] = w[i] / beta;
+            }
+        }
+
+        std::vector<double> projected = t;
+        eigh_buffer(projected, m, m, theta, s);
+        double scale = 0;
+        for (double value : theta)
+            scale = std::max(scale, std::abs(value));
+        int converged = 0;
+        for (int i = 0; i < k; i++)
+            converged += (beta * std::abs(s[static_cast<size_t>(i) * m + m - 1]) <= tol * scale);
+        if (converged == k || m == n)
+            break;
+        if (restart == max_restarts)
+            assert(("The eigenvalues did not converge", false));
+
+        // Keep the p best Ritz vectors and the residual direction
+        int p = std::min(m - 1, k + (m - k) / 2);
+        std::vector<double> ritz(static_cast<size_t>(p) * n);
+        kernels::gemm(p, n, m, 1, s.data(), m, v.data(), n, 0, ritz.data(), n);
+        std::copy(ritz.begin(), ritz.end(), v.begin());
+        std::copy(row(m), row(m) + n, row(p));
+        std::fill(t.begin(), t.end(), 0);
+        for (int i = 0; i < p; i++)
+            t[static_cast<size_t>(i) * m + i] = theta[i];
+        l = p;
+    }
+
+    values.assign(theta.begin(), theta.begin() + k);
+    vectors.resize(static_cast<size_t>(k) * n);
+    kernels::gemm(k, n, m, 1, s.data(), m, v.data(), n, 0, vectors.data(), n);
+}
+
+/// Method to turn the eigenpairs of lanczos() into an Eigh object
+static Eigh eigsh_result(const std::vector<double> &values, const std::vector<double> &vectors,
+                         int n, int k) {
+    Eigh result;
+    result.values = kernels::unpack(values, 1, k);
+    result.vectors = kernels::unpack(transpose_buffer(vectors, k, n), n, k);
+    return result;
+}
+
+/** Method to calculate the k largest eigenvalues and their eigenvectors of a symmetric Matrix
+   Uses Lanczos iterations, which only need products A * x, so it is much faster than eigh()
+   when k is small compared to the size of the Matrix. For the smallest eigenvalues, e.g. of a
+   graph Laplacian, pass -A and negate the values.
+*/
+Eigh MatrixOp::eigsh(Matrix mat, int k) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (mat.row_length() != mat.col_length())
+        assert(("The Matrix must be a square matrix", false));
+
+    int n = mat.row_length();
+    if (k < 1 || k > n)
+        assert(("The number of eigenvalues is out of range", false));
+
+    std::vector<double> a = kernels::pack(mat);
+    LinearOperator apply = [&a, n](const double *x, double *y) {
+        kernels::gemm(n, 1, n, 1, a.data(), n, x, 1, 0, y, 1);
+    };
+    std::vector<double> values, vectors;
+    lanczos(apply, n, k, values, vectors);
+    return eigsh_result(values, vectors, n, k);
+}
+
+/** Method to calculate the k largest eigenpairs of a symmetric operator of size n
+   A is only called as y = A * x, so the Matrix never has to be formed.
+*/
+Eigh MatrixOp::eigsh(LinearOperator A, int n, int k) {
+    if (k < 1 || k > n)
+        assert(("The number of eigenvalues is out of range", false));
+
+    std::vector<double> values, vectors;
+    lanczos(A, n, k, values, vectors);
+    return eigsh_result(values, vectors, n, k);
+}
+
+/** Method to solve the linear system A * X = B without forming the inverse of A
+   Every column of B is a right hand side. Use lu() and LU::solve() to reuse the factorization
+   of A across repeated solves.
+*/
+Matrix MatrixOp::solve(Matrix A, Matrix B) { return lu(A).solve(B); }
+
+/** Method to solve A * X = B with a single precision LU and double precision refinement
+   Each step solves for the correction A * D = R with the single precision factors, where
+   R = B - A * X is computed in double precision. The refinement stops once every column has a
+   backward error ||r||_inf / (||A||_inf * ||x||_inf) below sqrt(n) * epsilon. If the backward
+   error stops halving, as happens when the condition number of A is above about 1e7, or A does
+   not fit in single precision, A is factorized again in double precision.
+*/
+SolveMixed MatrixOp::solve_mixed(Matrix A, Matrix B) {
+    bool error = A.if_double && B.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (A.row_length() != A.col_length())
+        assert(("The Matrix must be a square matrix", false));
+    if (B.row_length() != A.row_length())
+        assert(("The Matrix objects should be of compatible dimensions", false));
+
+    int n = A.row_length(), nrhs = B.col_length();
+    const int max_iterations = 30;
+    std::vector<double> a = kernels::pack(A), b = kernels::pack(B);
+
+    SolveMixed result;
+    double a_norm = 0;
+    bool overflow = false;
+    std::vector<float> a_single(a.size());
+    for (int i = 0; i < n; i++) {
+        double row = 0;
+        for (int j = 0; j < n; j++) {
+            double a_ij = a[static_cast<size_t>(i) * n + j];
+            row += std::abs(a_ij);
+            overflow = overflow || (std::abs(a_ij) > std::numeric_limits<float>::max());
+            a_single[static_cast<size_t>(i) * n + j] = static_cast<float>(a_ij);
+        }
+        a_norm = std::max(a_norm, row);
+    }
+
+    std::vector<int> piv(n);
+    if (!overflow && !kernels::lu_factor_float(a_single.data(), n, n, piv.data())) {
+        double threshold = std::sqrt(n) * std::numeric_limits<double>::epsilon();
+        double previous = std::numeric_limits<double>::infinity();
+        std::vector<double> x(b.size(), 0), r = b;
+        std::vector<float> d(b.size());
+        for (int it = 0; it <= max_iterations; it++) {
+            // X = X + A^-1 * R with the single precision factors
+            for (size_t i = 0; i < r.size(); i++)
+                d[i] = static_cast<float>(r[i]);
+            kernels::lu_solve_float(a_single.data(), n, n, piv.data(), d.data(), nrhs, nrhs);
+            for (size_t i = 0; i < x.size(); i++)
+                x[i] += d[i];
+
+            // R = B - A * X in double precision
+            r = b;
+            kernels::gemm(n, nrhs, n, -1, a.data(), n, x.data(), nrhs, 1, r.data(), nrhs);
+
+            double backward_error = 0;
+            for (int c = 0; c < nrhs; c++) {
+                double r_norm = 0, x_norm = 0;
+                for (int i = 0; i < n; i++) {
+                    r_norm = std::max(r_norm, std::abs(r[static_cast<size_t>(i) * nrhs + c]));
+                    x_norm = std::max(x_norm, std::abs(x[static_cast<size_t>(i) * nrhs + c]));
+                }
+                if (r_norm > 0)
+                    backward_error = std::max(backward_error, r_norm / (a_norm * x_norm));
+            }
+            result.iterations = it;
+            if (backward_error <= threshold) {
+                result.X = kernels::unpack(x, n, nrhs);
+                return result;
+            }
+            if (!(backward_error < 0.5 * previous))
+                break;
+            previous = backward_error;
+        }
+    }
+
+    result.fallback = true;
+    result.X = lu(A).solve(B);
+    return result;
+}
+
+/** Preconditioned conjugate gradient iterations for A * x = b, starting from x = 0
+   The vector updates are fused so that every iteration makes two passes over the vectors
+   besides the products with A and M^-1: one updating x and r while summing r^T * r, and one
+   updating p. The sums are taken over fixed chunks of grain values whose partial sums are added
+   in order, so the result does not depend on the number of threads. The work vectors and the
+   std::function objects of the passes are built before the first iteration, so an iteration on
+   one thread does not allocate; on several threads each pass hands one job to the pool.
+*/
+static CG cg_iterate(const LinearOperator &apply_a, const LinearOperator &apply_m,
+                     const std::vector<double> &b, double tol, int maxit) {
+    int n = b.size();
+    const int grain = 4096;
+    int chunks = std::max((n + grain - 1) / grain, 1);
+    std::vector<double> x(n, 0), r = b, z(apply_m ? n : 0), p(n), q(n), partial(chunks, 0);
+    double *z_data = apply_m ? z.data() : r.data();
+
+    // The passes read their operands through these, so they are only built once
+    const double *u = nullptr, *v = nullptr;
+    double alpha = 0, beta = 0;
+    const std::function<void(int, int)> dot_pass = [&](int i0, int i1) {
+        for (int c0 = i0; c0 < i1; c0 += grain) {
+            double s = 0;
+            for (int i = c0; i < std::min(c0 + grain, i1); i++)
+                s += u[i] * v[i];
+            partial[c0 / grain] = s;
+        }
+    };
+    // x = x + alpha * p and r = r - alpha * q, fused with r^T * r
+    const std::function<void(int, int)> update_pass = [&](int i0, int i1) {
+        for (int c0 = i0; c0 < i1; c0 += grain) {
+            double s = 0;
+            for (int i = c0; i < std::min(c0 + grain, i1); i++) {
+                x[i] += alpha * p[i];
+                r[i] -= alpha * q[i];
+                s += r[i] * r[i];
+            }
+            partial[c0 / grain] = s;
+        }
+    };
+    const std::function<void(int, int)> direction_pass = [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++)
+            p[i] = z_data[i] + beta * p[i];
+    };
+    auto sum_chunks = [&](const std::function<void(int, int)> &pass) {
+        kernels::parallel_for(0, n, grain, pass);
+        double total = 0;
+        for (double value : partial)
+            total += value;
+        return total;
+    };
+    auto dot = [&](const double *a, const double *c) {
+        u = a;
+        v = c;
+        return sum_chunks(dot_pass);
+    };
+
+    CG result;
+    double b_norm = std::sqrt(dot(b.data(), b.data()));
+    if (b_norm == 0) {
+        result.x = kernels::unpack(x, n, 1);
+        result.converged = true;
+        return result;
+    }
+
+    if (apply_m)
+        apply_m(r.data(), z_data);
+    std::copy(z_data, z_data + n, p.begin());
+    double rz = dot(r.data(), z_data);
+
+    result.residual = 1;
+    for (int it = 1; it <= maxit; it++) {
+        apply_a(p.data(), q.data());
+        double pq = dot(p.data(), q.data());
+        if (!(pq > 0))
+            assert(("The Matrix is not positive definite", false));
+        alpha = rz / pq;
+
+        double rr = sum_chunks(update_pass);
+        result.iterations = it;
+        result.residual = std::sqrt(rr) / b_norm;
+        if (result.residual <= tol) {
+            result.converged = true;
+            break;
+        }
+
+        double rz_new = rr;
+        if (apply_m) {
+            apply_m(r.data(), z_data);
+            rz_new = dot(r.data(), z_data);
+        }
+        beta = rz_new / rz;
+        rz = rz_new;
+        kernels::parallel_for(0, n, grain, direction_pass);
+    }
+    result.x = kernels::unpack(x, n, 1);
+    return result;
+}
+
+/** Incomplete Cholesky factorization IC(0) of the lower triangle of a dense Matrix
+   L keeps the sparsity pattern of the lower triangle of A and is stored row by row as
+   (column, value) pairs sorted by column, with the diagonal last. When a pivot is not positive,
+   the factorization is restarted on A + shift * diag(A) with a growing shift.
+*/
+class IncompleteCholesky {
+  public:
+    int n = 0;
+    std::vector<int> row_start;
+    std::vector<int> cols;
+    std::vector<double> vals;
+
+    IncompleteCholesky(const std::vector<double> &, int);
+
+    // Member functions
+    bool factorize();
+    void solve(const double *r, double *z) const;
+};
+
+/// Method to copy the pattern of the lower triangle of a (n, n) buffer and factorize it
+IncompleteCholesky::IncompleteCholesky(const std::vector<double> &a, int n) : n(n) {
+    row_start.assign(n + 1, 0);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j <= i; j++) {
+            if (a[static_cast<size_t>(i) * n + j] != 0 || j == i) {
+                cols.push_back(j);
+                vals.push_back(a[static_cast<size_t>(i) * n + j]);
+            }
+        }
+        row_start[i + 1] = cols.size();
+        if (!(vals.back() > 0))
+            assert(("The Matrix is not positive definite", false));
+    }
+
+    std::vector<double> original = vals;
+    double shift = 0;
+    while (!factorize()) {
+        shift = (shift == 0) ? 1e-3 : 2 * shift;
+        vals = original;
+        for (int i = 0; i < n; i++)
+            vals[row_start[i + 1] - 1] *= 1 + shift;
+    }
+}
+
+/// Method to factorize in place, returns false if a pivot is not positive
+bool IncompleteCholesky::factorize() {
+    for (int i = 0; i < n; i++) {
+        int begin = row_start[i], end = row_start[i + 1];
+        for (int p = begin; p < end; p++) {
+            int k = cols[p];
+            // Sparse dot product of rows i and k of L over the columns before k
+            double s = vals[p];
+            int pi = begin, pk = row_start[k], pk_end = row_start[k + 1] - 1;
+            while (pi < p && pk < pk_end) {
+                if (cols[pi] == cols[pk])
+                    s -= vals[pi++] * vals[pk++];
+                else if (cols[pi] < cols[pk])
+                    pi++;
+                else
+                    pk++;
+            }
+            if (k < i) {
+                vals[p] = s / vals[row_start[k + 1] - 1];
+            } else {
+                if (!(s > 0))
+                    return false;
+                vals[p] = std::sqrt(s);
+            }
+        }
+    }
+    return true;
+}
+
+/// Method to solve L * L^T * z = r
+void IncompleteCholesky::solve(const double *r, double *z) const {
+    for (int i = 0; i < n; i++) {
+        double s = r[i];
+        int diag = row_start[i + 1] - 1;
+        for (int p = row_start[i]; p < diag; p++)
+            s -= vals[p] * z[cols[p]];
+        z[i] = s / vals[diag];
+    }
+    for (int i = n - 1; i >= 0; i--) {
+        int diag = row_start[i + 1] - 1;
+        z[i] /= vals[diag];
+        for (int p = row_start[i]; p < diag; p++)
+            z[cols[p]] -= vals[p] * z[i];
+    }
+}
+
+/// Method to solve A * x = b with unpreconditioned conjugate gradients
+CG MatrixOp::cg(Matrix A, Matrix b, double tol, int maxit) {
+    return cg(A, b, tol, maxit, "none");
+}
+
+/** Method to solve the symmetric positive definite system A * x = b with conjugate gradients
+   preconditioner is "none", "jacobi" (the diagonal of A) or "ichol" (incomplete Cholesky IC(0),
+   which skips the exact zeros of A). b must be a column vector, the iterations stop when
+   ||b - A * x|| <= tol * ||b|| or after maxit iterations.
+*/
+CG MatrixOp::cg(Matrix A, Matrix b, double tol, int maxit, std::string preconditioner) {
+    bool error = A.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (A.row_length() != A.col_length())
+        assert(("The Matrix must be a square matrix", false));
+    if (b.row_length() != A.row_length())
+        assert(("The Matrix objects should be of compatible dimensions", false));
+
+    int n = A.row_length();
+    std::vector<double> a = kernels::pack(A);
+    // The row products are built once and read x and y through these, so an iteration does not
+    // build a std::function
+    const double *x = nullptr;
+    double *y = nullptr;
+    const std::function<void(int, int)> row_products = [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) {
+            const double *a_i = a.data() + static_cast<size_t>(i) * n;
+            double s = 0;
+            for (int j = 0; j < n; j++)
+                s += a_i[j] * x[j];
+            y[i] = s;
+        }
+    };
+    int grain = std::max(1, 65536 / std::max(n, 1));
+    LinearOperator apply_a = [&](const double *in, double *out) {
+        x = in;
+        y = out;
+        kernels::parallel_for(0, n, grain, row_products);
+    };
+
+    if (preconditioner == "none")
+        return cg(apply_a, b, tol, maxit);
+    if (preconditioner == "jacobi") {
+        std::vector<double> inv_diag(n);
+        for (int i = 0; i < n; i++) {
+            double a_ii = a[static_cast<size_t>(i) * n + i];
+            if (!(a_ii > 0))
+                assert(("The Matrix is not positive definite", false));
+            inv_diag[i] = 1 / a_ii;
+        }
+        LinearOperator apply_m = [&inv_diag, n](const double *r, double *z) {
+            for (int i = 0; i < n; i++)
+                z[i] = inv_diag[i] * r[i];
+        };
+        return cg(apply_a, apply_m, b, tol, maxit);
+    }
+    if (preconditioner == "ichol") {
+        IncompleteCholesky factors(a, n);
+        LinearOperator apply_m = [&factors](const double *r, double *z) { factors.solve(r, z); };
+        return cg(apply_a, apply_m, b, tol, maxit);
+    }
+    assert(("Fifth parameter 'preconditioner' wrong", false));
+    return CG();
+}
+
+/// Method to solve A * x = b with conjugate gradients, A given as a LinearOperator
+CG MatrixOp::cg(LinearOperator A, Matrix b, double tol, int maxit) {
+    return cg(A, LinearOperator(), b, tol, maxit);
+}
+
+/** Method to solve A * x = b with preconditioned conjugate gradients
+   A and the preconditioner M^-1 are both given as LinearOperator objects, M^-1 may be empty.
+*/
+CG MatrixOp::cg(LinearOperator A, LinearOperator M, Matrix b, double tol, int maxit) {
+    bool error = b.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (b.col_length() != 1)
+        assert(("The right hand side must be a column vector", false));
+    if (tol <= 0 || maxit < 0)
+        assert(("The tolerance must be positive and maxit must not be negative", false));
+
+    return cg_iterate(A, M, kernels::pack(b), tol, maxit);
+}
@@ -0,0 +1,124 @@
+#ifndef _matrix_linalg_hpp_
+#define _matrix_linalg_hpp_
+
+#include <matrix_basic.hpp>
+
+#include <functional>
+
+/** LU factorization P * A = L * U of a square Matrix
+   The factors are stored packed in a contiguous row-major buffer (L below the diagonal with an
+   implicit unit diagonal, U on and above it), so one factorization can be reused for any number
+   of solves with the same Matrix.
+*/
+class LU {
+  public:
+    int n = 0;
+    int sign = 1;
+    bool singular = false;
+    std::vector<double> lu;
+    std::vector<int> piv;
+
+    // Member functions
+    Matrix L();
+    Matrix U();
+    Matrix solve(Matrix);
+    double determinant();
+    double logdet();
+    Matrix inverse();
+};
+
+/** Result of a mixed precision solve A * X = B
+   iterations is the number of refinement steps done after the single precision solve. fallback
+   is true when the refinement did not converge and X comes from a double precision LU instead.
+*/
+class SolveMixed {
+  public:
+    Matrix X;
+    int iterations = 0;
+    bool fallback = false;
+};
+
+/** Cholesky factorization A = L * L^T of a symmetric positive definite Matrix
+   Only the lower triangle of the Matrix is read. When the Matrix is not positive definite,
+   positive_definite is false and the LU factorization is kept instead, so that solve() and
+   logdet() still give an answer.
+*/
+class Cholesky {
+  public:
+    int n = 0;
+    bool positive_definite = false;
+    std::vector<double> l;
+    LU lu;
+
+    // Member functions
+    Matrix L();
+    Matrix solve(Matrix);
+    double logdet();
+};
+
+/** Householder QR factorization A = Q * R of a (m, n) Matrix
+   R and the Householder vectors are stored packed in a contiguous row-major buffer, Q is only
+   formed when asked for.
+*/
+class QR {
+  public:
+    int rows = 0;
+    int cols = 0;
+    std::vector<double> qr;
+    std::vector<double> tau;
+
+    // Member functions
+    Matrix Q();
+    Matrix R();
+};
+
+/** Result of a linear least squares fit X * coef = y
+   coef has one column per column of y, residuals is a row vector holding the sum of squared
+   residuals of each column of y.
+*/
+class Lstsq {
+  public:
+    Matrix coef;
+    Matrix residuals;
+};
+
+/** Eigendecomposition A * vectors = vectors * diag(values) of a symmetric Matrix
+   values is a row vector sorted in descending order and column j of vectors is the unit
+   eigenvector of values(0, j).
+*/
+class Eigh {
+  public:
+    Matrix values;
+    Matrix vectors;
+};
+
+/** Singular value decomposition A = U * diag(S) * V^T
+   S is a row vector sorted in descending order, the columns of U and V are the matching left
+   and right singular vectors.
+*/
+class SVD {
+  public:
+    Matrix U;
+    Matrix S;
+    Matrix V;
+};
+
+/** Linear operator y = A * x on vectors of length n, used by the iterative solvers
+   The operator writes its result into y and must not keep the pointers, so that the solvers can
+   call it on their own work vectors without allocating.
+*/
+using LinearOperator = std::function<void(const double *x, double *y)>;
+
+/** Result of a conjugate gradient solve A * x = b
+   residual is the final ||b - A * x|| / ||b||, and converged is true if it reached the requested
+   tolerance within the maximum number of iterations.
+*/
+class CG {
+  public:
+    Matrix x;
+    int iterations = 0;
+    double residual = 0;
+    bool converged = false;
+};
+
+#endif /* _matrix_linalg_hpp_ */
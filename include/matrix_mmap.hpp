@@ -0,0 +1,29 @@
+#ifndef _matrix_mmap_hpp_
+#define _matrix_mmap_hpp_
+
+#include <string>
+#include <vector>
+
+/** Read-only view of a whole file
+   The file is memory-mapped, so the pages are read by the kernel as they are used and nothing
+   is copied. sequential tells the kernel that the file is read once from start to end, so it
+   reads ahead. Platforms without mmap read the file into a buffer instead.
+*/
+class MappedFile {
+  public:
+    const char *data = nullptr;
+    size_t size = 0;
+
+    MappedFile(const std::string &filename, bool sequential);
+    ~MappedFile();
+    void release(const char *upto);
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+  private:
+    void *map = nullptr;
+    size_t released = 0;
+    std::vector<char> buffer;
+};
+
+#endif /* _matrix_mmap_hpp_ */
@@ -1,23 +1,7 @@
+#include <matrix_kernels.hpp>
 #include <matrix_operations.hpp>
 
-/// Method to read a csv file and return a Matrix object
-Matrix MatrixOp::genfromtxt(std::string filename, char delim) {
-    Matrix mat;
-    std::ifstream file(filename);
-    std::string line, cell;
-    std::vector<std::string> cells;
-
-    while (std::getline(file, line)) {
-        std::stringstream ss(line);
-        while (std::getline(ss, cell, delim)) {
-            cells.push_back(cell);
-        }
-        mat.str_mat.push_back(cells);
-        cells.clear();
-    }
-
-    return mat;
-}
+#include <limits>
 
 /// Method to initialize values of a Matrix object using a 2D vector
 Matrix MatrixOp::init(std::vector<std::vector<double>> vec) {
@@ -96,6 +80,111 @@ Matrix MatrixOp::concatenate(Matrix mat1, Matrix mat2, std::string dim) {
     return mat1;
 }
 
+/** Method to assemble a Matrix from a grid of blocks
+   The blocks of a row of the grid must have the same number of rows, and every row of the grid
+   the same total number of columns. Each value and its string are copied once, straight into
+   their row of the result, so nothing is parsed or formatted again.
+*/
+Matrix MatrixOp::block(const std::vector<std::vector<MatrixBlock>> &blocks) {
+    int rows = 0, cols = -1;
+    for (const std::vector<MatrixBlock> &block_row : blocks) {
+        if (block_row.empty())
+            assert(("Every row of blocks must hold at least one Matrix object", false));
+        int height = block_row[0].mat->row_length(), width = 0;
+        for (const MatrixBlock &block : block_row) {
+            const Matrix &mat = *block.mat;
+            bool error = mat.if_double;
+            if (!error)
+                assert(("The Matrix should be first converted to double using to_double() method",
+                        error));
+            if (mat.row_length() != height)
+                assert(("The Matrix objects should be of compatible dimensions", false));
+            width += mat.col_length();
+        }
+        if (cols != -1 && width != cols)
+            assert(("The Matrix objects should be of compatible dimensions", false));
+        cols = width;
+        rows += height;
+    }
+
+    Matrix result;
+    result.double_mat.resize(rows);
+    result.str_mat.resize(rows);
+    int row = 0;
+    for (const std::vector<MatrixBlock> &block_row : blocks) {
+        int height = block_row[0].mat->row_length();
+        for (int i = 0; i < height; i++) {
+            std::vector<double> &out = result.double_mat[row + i];
+            std::vector<std::string> &out_str = result.str_mat[row + i];
+            out.reserve(cols);
+            out_str.reserve(cols);
+            for (const MatrixBlock &block : block_row) {
+                const Matrix &mat = *block.mat;
+                out.insert(out.end(), mat.double_mat[i].begin(), mat.double_mat[i].end());
+                out_str.insert(out_str.end(), mat.str_mat[i].begin(), mat.str_mat[i].end());
+            }
+        }
+        row += height;
+    }
+    result.if_double = true;
+    return result;
+}
+
+/** Method to calculate the Kronecker product of two Matrix objects
+   Row (i1 * m2 + i2) of the result is made of the row i2 of mat2 scaled by each value of the
+   row i1 of mat1, so every value is written once by a contiguous loop.
+*/
+Matrix MatrixOp::kron(const Matrix &mat1, const Matrix &mat2) {
+    bool error = mat1.if_double && mat2.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    int m1 = mat1.row_length(), n1 = mat1.col_length();
+    int m2 = mat2.row_length(), n2 = mat2.col_length();
+    Matrix result;
+    result.double_mat.resize(m1 * m2);
+    for (int i1 = 0; i1 < m1; i1++) {
+        for (int i2 = 0; i2 < m2; i2++) {
+            std::vector<double> &out = result.double_mat[i1 * m2 + i2];
+            out.resize(n1 * n2);
+            const double *b_row = mat2.double_mat[i2].data();
+            for (int j1 = 0; j1 < n1; j1++) {
+                double a = mat1.double_mat[i1][j1];
+                double *out_block = out.data() + j1 * n2;
+                for (int j2 = 0; j2 < n2; j2++)
+                    out_block[j2] = a * b_row[j2];
+            }
+        }
+    }
+    result.to_string();
+    return result;
+}
+
+/** Method to calculate the outer product u * v^T of two vectors
+   u and v can each be a row or a column vector, the result is of size (len(u), len(v)).
+*/
+Matrix MatrixOp::outer(const Matrix &u, const Matrix &v) {
+    bool error = u.if_double && v.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if ((u.row_length() != 1 && u.col_length() != 1) ||
+        (v.row_length() != 1 && v.col_length() != 1))
+        assert(("The Matrix objects should be row or column vectors", false));
+
+    std::vector<double> x = kernels::pack(u), y = kernels::pack(v);
+    Matrix result;
+    result.double_mat.resize(x.size());
+    for (size_t i = 0; i < x.size(); i++) {
+        std::vector<double> &out = result.double_mat[i];
+        out.resize(y.size());
+        for (size_t j = 0; j < y.size(); j++)
+            out[j] = x[i] * y[j];
+    }
+    result.to_string();
+    return result;
+}
+
 /// Method to calculate matrix multiplication
 Matrix MatrixOp::matmul(Matrix mat1, Matrix mat2) {
     bool error = (mat1.if_double) && (mat2.if_double);
@@ -105,23 +194,103 @@ Matrix MatrixOp::matmul(Matrix mat1, Matrix mat2) {
     if (mat1.col_length() != mat2.row_length())
         assert(("The Matrix objects should be of compatible dimensions", false));
 
-    Matrix mat;
-    for (int i = 0; i < mat1.row_length(); i++) {
-        std::vector<double> row;
-        for (int j = 0; j < mat2.col_length(); j++) {
-            row.push_back(0);
+    int m = mat1.row_length(), k = mat1.col_length(), n = mat2.col_length();
+    std::vector<double> a = kernels::pack(mat1), b = kernels::pack(mat2);
+    std::vector<double> c(static_cast<size_t>(m) * n);
+    kernels::gemm(m, n, k, 1, a.data(), k, b.data(), n, 0, c.data(), n);
+    return kernels::unpack(c, m, n);
+}
+
+/** Method to compute the product of the chain i..j into c, in the order given by split
+   Buffers of the intermediate products are taken from spare and given back once they have been
+   used, so a chain allocates at most one buffer per level of the product tree.
+*/
+static void chain_product(const std::vector<std::vector<double>> &bufs,
+                          const std::vector<int> &dims, const std::vector<int> &split, int i, int j,
+                          std::vector<double> &c, std::vector<std::vector<double>> &spare) {
+    int count = bufs.size();
+    int s = split[i * count + j];
+    std::vector<double> left, right;
+    const double *a = bufs[i].data(), *b = bufs[j].data();
+    if (s > i) {
+        if (!spare.empty()) {
+            left = std::move(spare.back());
+            spare.pop_back();
         }
-        mat.double_mat.push_back(row);
+        chain_product(bufs, dims, split, i, s, left, spare);
+        a = left.data();
+    }
+    if (s + 1 < j) {
+        if (!spare.empty()) {
+            right = std::move(spare.back());
+            spare.pop_back();
+        }
+        chain_product(bufs, dims, split, s + 1, j, right, spare);
+        b = right.data();
+    }
+
+    c.resize(static_cast<size_t>(dims[i]) * dims[j + 1]);
+    kernels::gemm(dims[i], dims[j + 1], dims[s + 1], 1, a, dims[s + 1], b, dims[j + 1], 0,
+                  c.data(), dims[j + 1]);
+    if (s > i)
+        spare.push_back(std::move(left));
+    if (s + 1 < j)
+        spare.push_back(std::move(right));
+}
+
+/** Method to multiply a chain of Matrix objects in the cheapest order
+   The parenthesization with the fewest scalar multiplications is found with the O(n^3) matrix
+   chain dynamic program, so (10000, 10) * (10, 10000) * (10000, 5) is computed as
+   A * (B * C). The chain holds MatrixBlock objects, so the operands are not copied, the
+   products run in gemm on contiguous buffers and no Matrix object is built for the
+   intermediate results.
+*/
+Matrix MatrixOp::multi_dot(const std::vector<MatrixBlock> &mats) {
+    if (mats.empty())
+        assert(("At least one Matrix object is needed", false));
+    for (const MatrixBlock &mat : mats) {
+        bool error = mat.mat->if_double;
+        if (!error)
+            assert(("The Matrix should be first converted to double using to_double() method",
+                    error));
+    }
+
+    int count = mats.size();
+    std::vector<int> dims(count + 1);
+    dims[0] = mats[0].mat->row_length();
+    for (int i = 0; i < count; i++) {
+        if (mats[i].mat->row_length() != dims[i])
+            assert(("The Matrix objects should be of compatible dimensions", false));
+        dims[i + 1] = mats[i].mat->col_length();
     }
-    for (unsigned long int i = 0; i < mat1.row_length(); i++) {
-        for (unsigned long int j = 0; j < mat2.col_length(); j++) {
-            for (unsigned long int k = 0; k < mat2.row_length(); k++) {
-                mat.double_mat[i][j] += (mat1.double_mat[i][k] * mat2.double_mat[k][j]);
+    if (count == 1)
+        return *mats[0].mat;
+
+    // cost[i][j] is the cheapest number of multiplications for the chain i..j, and the chain
+    // is split as (i..split[i][j]) * (split[i][j]+1..j)
+    std::vector<double> cost(static_cast<size_t>(count) * count, 0);
+    std::vector<int> split(static_cast<size_t>(count) * count, 0);
+    for (int len = 2; len <= count; len++) {
+        for (int i = 0; i + len - 1 < count; i++) {
+            int j = i + len - 1;
+            cost[i * count + j] = std::numeric_limits<double>::infinity();
+            for (int s = i; s < j; s++) {
+                double c = cost[i * count + s] + cost[(s + 1) * count + j] +
+                           static_cast<double>(dims[i]) * dims[s + 1] * dims[j + 1];
+                if (c < cost[i * count + j]) {
+                    cost[i * count + j] = c;
+                    split[i * count + j] = s;
+                }
             }
         }
     }
-    mat.to_string();
-    return mat;
+
+    std::vector<std::vector<double>> bufs(count), spare;
+    for (int i = 0; i < count; i++)
+        bufs[i] = kernels::pack(*mats[i].mat);
+    std::vector<double> result;
+    chain_product(bufs, dims, split, 0, count - 1, result, spare);
+    return kernels::unpack(result, dims[0], dims[count]);
 }
 
 /// Method to create an Matrix of all elements 0
@@ -154,48 +323,6 @@ Matrix MatrixOp::eye(int size) {
     return result;
 }
 
-/// Method to calculate the Determinant of a Matrix
-double MatrixOp::determinant(Matrix mat, int n) {
-    bool error = mat.if_double;
-    if (!error)
-        assert(("The Matrix should be first converted to double using to_double() method", error));
-
-    if (mat.row_length() != mat.col_length())
-        assert(("The Matrix must be a square matrix", false));
-
-    double D = 0;
-    if (n == 1)
-        return mat.double_mat[0][0];
-
-    int sign = 1;
-    Matrix temp = zeros(n, n);
-
-    for (int f = 0; f < n; f++) {
-        temp = cofactor(mat, temp, 0, f);
-        D += sign * mat.double_mat[0][f] * determinant(temp, n - 1);
-        sign = -sign;
-    }
-
-    return D;
-}
-
-/// Method to calculate the Inverse of a Matrix
-Matrix MatrixOp::inverse(Matrix mat) {
-    bool error = mat.if_double;
-    if (!error)
-        assert(("The Matrix should be first converted to double using to_double() method", error));
-
-    if (mat.row_length() != mat.col_length())
-        assert(("The Matrix must be a square matrix", false));
-    double det = determinant(mat, mat.col_length());
-    if (det == 0)
-        assert(("The Matrix is singular", false));
-
-    Matrix adj = adjoint(mat);
-    Matrix result = adj / det;
-    return result;
-}
-
 /// Method to calculate the sum over an axis of a Matrix
 Matrix MatrixOp::sum(Matrix mat, std::string dim) {
     bool error = mat.if_double;
@@ -206,22 +333,19 @@ Matrix MatrixOp::sum(Matrix mat, std::string dim) {
     if (dim == "column") {
         result = zeros(1, mat.col_length());
         for (int i = 0; i < mat.row_length(); i++) {
-            for (int j = 0; j < mat.col_length(); j++) {
-                result(0, j) = result(0, j) + mat(i, j);
-                result(0, j);
-            }
+            for (int j = 0; j < mat.col_length(); j++)
+                result.double_mat[0][j] += mat.double_mat[i][j];
         }
     } else if (dim == "row") {
         result = zeros(mat.row_length(), 1);
         for (int i = 0; i < mat.col_length(); i++) {
-            for (int j = 0; j < mat.row_length(); j++) {
-                result(j, 0) = result(j, 0) + mat(j, i);
-                result(j, 0);
-            }
+            for (int j = 0; j < mat.row_length(); j++)
+                result.double_mat[j][0] += mat.double_mat[j][i];
         }
     } else {
         assert(("Second parameter 'dimension' wrong", false));
     }
+    result.to_string();
     return result;
 }
 
@@ -591,45 +715,8 @@ Matrix MatrixOp::reciprocal(Matrix mat) {
     return init(res);
 }
 
-// Helper methods
+/// Method to set the number of threads used by the parallel methods
+void MatrixOp::set_num_threads(int count) { kernels::set_num_threads(count); }
 
-/// Helper method to calculate cofactor
-Matrix MatrixOp::cofactor(Matrix mat, Matrix temp, int p, int q) {
-    int i = 0, j = 0;
-    for (int row = 0; row < mat.row_length(); row++) {
-        for (int col = 0; col < mat.col_length(); col++) {
-            if (row != p && col != q) {
-                temp.double_mat[i][j++] = mat.double_mat[row][col];
-                if (j == mat.col_length() - 1) {
-                    j = 0;
-                    i++;
-                }
-            }
-        }
-    }
-    temp.to_string();
-    return temp;
-}
-
-/// Helper method to calculate the Adjoint of a Matrix
-Matrix MatrixOp::adjoint(Matrix mat) {
-    Matrix result = zeros(mat.row_length(), mat.col_length());
-
-    if (mat.col_length() == 1) {
-        result.double_mat[0][0] = 1;
-        return result;
-    }
-
-    int sign = 1;
-    Matrix temp = zeros(mat.row_length(), mat.col_length());
-
-    for (int i = 0; i < mat.row_length(); i++) {
-        for (int j = 0; j < mat.col_length(); j++) {
-            temp = cofactor(mat, temp, i, j);
-            sign = ((i + j) % 2 == 0) ? 1 : -1;
-            result.double_mat[j][i] = (sign) * (determinant(temp, temp.col_length() - 1));
-        }
-    }
-
-    return result;
-}
\ No newline at end of file
+/// Method to get the number of threads used by the parallel methods
+int MatrixOp::get_num_threads() { return kernels::num_threads(); }
@@ -2,12 +2,26 @@
 #define _matrix_operations_hpp_
 
 #include <matrix_basic.hpp>
+#include <matrix_batch.hpp>
+#include <matrix_csv.hpp>
+#include <matrix_io.hpp>
+#include <matrix_linalg.hpp>
+#include <matrix_sparse.hpp>
+#include <matrix_stats.hpp>
+#include <matrix_structured.hpp>
 
-class MatrixOp {
-  private:
-    Matrix cofactor(Matrix, Matrix, int, int);
-    Matrix adjoint(Matrix);
+/** Block of a grid given to MatrixOp::block(), or operand of MatrixOp::multi_dot()
+   Only the address of the Matrix object is kept, so building the grid does not copy the blocks.
+   Temporaries in the grid live until the end of the call.
+*/
+class MatrixBlock {
+  public:
+    const Matrix *mat;
 
+    MatrixBlock(const Matrix &mat) : mat(&mat) {}
+};
+
+class MatrixOp {
   public:
     Matrix init(std::vector<std::vector<double>>);
     Matrix init(std::vector<std::vector<std::string>>);
@@ -16,12 +30,61 @@ class MatrixOp {
     Matrix init(std::vector<double>);
     Matrix init(std::vector<std::string>);
     Matrix concatenate(Matrix, Matrix, std::string);
+    Matrix block(const std::vector<std::vector<MatrixBlock>> &);
+    Matrix kron(const Matrix &, const Matrix &);
+    Matrix outer(const Matrix &, const Matrix &);
     Matrix matmul(Matrix, Matrix);
+    Matrix matmul(SparseMatrix, Matrix);
+    Matrix multi_dot(const std::vector<MatrixBlock> &);
+    MatrixBatch batch(const std::vector<double> &, int, int, int);
+    MatrixBatch batch(const std::vector<Matrix> &);
+    MatrixBatch matmul(const MatrixBatch &, const MatrixBatch &);
+    Matrix matmul(const DiagonalMatrix &, Matrix);
+    Matrix matmul(Matrix, const DiagonalMatrix &);
+    Matrix matmul(const TriangularMatrix &, Matrix);
+    Matrix matmul(const SymmetricMatrix &, Matrix);
     Matrix zeros(int, int);
     Matrix ones(int, int);
     Matrix eye(int);
+    DiagonalMatrix diag(Matrix);
+    TriangularMatrix tril(Matrix);
+    TriangularMatrix triu(Matrix);
+    SymmetricMatrix symmetric(Matrix);
     double determinant(Matrix, int);
+    std::vector<double> determinant(const MatrixBatch &);
+    double determinant(const DiagonalMatrix &);
+    double determinant(const TriangularMatrix &);
+    double determinant(const SymmetricMatrix &);
     Matrix inverse(Matrix);
+    MatrixBatch inverse(const MatrixBatch &);
+    DiagonalMatrix inverse(const DiagonalMatrix &);
+    TriangularMatrix inverse(const TriangularMatrix &);
+    SymmetricMatrix inverse(const SymmetricMatrix &);
+    LU lu(Matrix);
+    Matrix solve(Matrix, Matrix);
+    MatrixBatch solve(const MatrixBatch &, const MatrixBatch &);
+    Matrix solve(const DiagonalMatrix &, Matrix);
+    Matrix solve(const TriangularMatrix &, Matrix);
+    Matrix solve(const SymmetricMatrix &, Matrix);
+    SolveMixed solve_mixed(Matrix, Matrix);
+    CG cg(Matrix, Matrix, double, int);
+    CG cg(Matrix, Matrix, double, int, std::string);
+    CG cg(LinearOperator, Matrix, double, int);
+    CG cg(LinearOperator, LinearOperator, Matrix, double, int);
+    Cholesky cholesky(Matrix);
+    Matrix cho_solve(Cholesky, Matrix);
+    double logdet(Matrix);
+    QR qr(Matrix);
+    Lstsq lstsq(Matrix, Matrix);
+    Eigh eigh(Matrix);
+    Eigh eigh(Matrix, int);
+    SVD svd(Matrix);
+    SVD svd(Matrix, int);
+    SVD randomized_svd(Matrix, int, int, int);
+    SVD randomized_svd(Matrix, int, int, int, unsigned int);
+    Eigh eigsh(Matrix, int);
+    Eigh eigsh(LinearOperator, int, int);
+    Eigh eigsh(SparseMatrix, int);
     Matrix sum(Matrix, std::string);
     Matrix mean(Matrix, std::string);
     Matrix std(Matrix, std::string);
@@ -29,16 +92,39 @@ class MatrixOp {
     Matrix max(Matrix, std::string);
     Matrix argmin(Matrix, std::string);
     Matrix argmax(Matrix, std::string);
+    Matrix nansum(const Matrix &, std::string);
+    Matrix nanmean(const Matrix &, std::string);
+    Matrix nanstd(const Matrix &, std::string);
+    Matrix nanmin(const Matrix &, std::string);
+    Matrix nanmax(const Matrix &, std::string);
+    Matrix nanargmax(const Matrix &, std::string);
     Matrix sqrt(Matrix);
+    SparseMatrix sqrt(SparseMatrix);
     Matrix power(Matrix, Matrix);
     Matrix power(Matrix, double);
+    SparseMatrix power(SparseMatrix, double);
     Matrix slice_select(Matrix, Matrix, double, int);
     Matrix delete_(Matrix, int, std::string);
     Matrix exp(Matrix);
     Matrix log(Matrix);
     Matrix abs(Matrix);
+    SparseMatrix abs(SparseMatrix);
     Matrix reciprocal(Matrix);
     Matrix genfromtxt(std::string, char);
+    Matrix genfromtxt(std::string, char, int);
+    Matrix genfromtxt(std::string, char, int, int);
+    CsvTable genfromtxt(std::string, const CsvOptions &);
+    void savetxt(const Matrix &, std::string, char, std::string);
+    SparseMatrix sparse(Matrix);
+    SparseMatrix genfromtxt_sparse(std::string, char, int);
+    void save(const Matrix &, std::string);
+    MatrixView load(std::string);
+    MatrixView load_npy(std::string);
+    void save_npy(const Matrix &, std::string);
+    std::map<std::string, MatrixView> load_npz(std::string);
+    void save_npz(const std::map<std::string, Matrix> &, std::string);
+    void set_num_threads(int);
+    int get_num_threads();
 
 };
 
@@ -0,0 +1,322 @@
+#include <matrix_kernels.hpp>
+#include <matrix_operations.hpp>
+
+#include <cstdlib>
+
+/// Rows handed to a thread at a time by the parallel sparse methods
+static const int sparse_grain = 256;
+
+/** Method to transpose a compressed Matrix with a counting sort over the inner indices
+   Used both for CSR to CSC and for CSC to CSR. The outer indices come out sorted within every
+   inner slice since the outer slices are visited in order.
+*/
+static void transpose_compressed(int outer, int inner, const std::vector<int> &indptr,
+                                 const std::vector<int> &indices, const std::vector<double> &data,
+                                 std::vector<int> &t_indptr, std::vector<int> &t_indices,
+                                 std::vector<double> &t_data) {
+    t_indptr.assign(inner + 1, 0);
+    for (int idx : indices)
+        t_indptr[idx + 1]++;
+    for (int j = 0; j < inner; j++)
+        t_indptr[j + 1] += t_indptr[j];
+
+    t_indices.resize(indices.size());
+    t_data.resize(data.size());
+    std::vector<int> next(t_indptr.begin(), t_indptr.end() - 1);
+    for (int i = 0; i < outer; i++) {
+        for (int p = indptr[i]; p < indptr[i + 1]; p++) {
+            int dest = next[indices[p]]++;
+            t_indices[dest] = i;
+            t_data[dest] = data[p];
+        }
+    }
+}
+
+/** Method to combine two sparse matrices element-wise with op(a_ij, b_ij)
+   With keep_union, entries present in only one of the matrices are combined with 0 as the other
+   operand, otherwise only the entries present in both are kept. Exact zeros in the result are
+   dropped. A first pass counts the entries of every row so that the rows are then filled in
+   parallel.
+*/
+template <typename Op>
+static SparseMatrix combine(const SparseMatrix &a, const SparseMatrix &b, Op op, bool keep_union) {
+    if ((a.rows != b.rows) || (a.cols != b.cols))
+        assert(("The SparseMatrix objects should be of the same dimensions", false));
+
+    auto merge_row = [&](int i, int *out_indices, double *out_data) {
+        int pa = a.indptr[i], ea = a.indptr[i + 1], pb = b.indptr[i], eb = b.indptr[i + 1];
+        int count = 0;
+        while ((pa < ea) || (pb < eb)) {
+            int col;
+            double value;
+            if ((pb == eb) || ((pa < ea) && (a.indices[pa] < b.indices[pb]))) {
+                col = a.indices[pa];
+                value = keep_union ? op(a.data[pa], 0.0) : 0;
+                pa++;
+            } else if ((pa == ea) || (b.indices[pb] < a.indices[pa])) {
+                col = b.indices[pb];
+                value = keep_union ? op(0.0, b.data[pb]) : 0;
+                pb++;
+            } else {
+                col = a.indices[pa];
+                value = op(a.data[pa++], b.data[pb++]);
+            }
+            if (value != 0) {
+                if (out_indices != nullptr) {
+                    out_indices[count] = col;
+                    out_data[count] = value;
+                }
+                count++;
+            }
+        }
+        return count;
+    };
+
+    SparseMatrix result;
+    result.rows = a.rows;
+    result.cols = a.cols;
+    result.indptr.assign(a.rows + 1, 0);
+    kernels::parallel_for(0, a.rows, sparse_grain, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++)
+            result.indptr[i + 1] = merge_row(i, nullptr, nullptr);
+    });
+    for (int i = 0; i < a.rows; i++)
+        result.indptr[i + 1] += result.indptr[i];
+
+    result.indices.resize(result.indptr[a.rows]);
+    result.data.resize(result.indptr[a.rows]);
+    kernels::parallel_for(0, a.rows, sparse_grain, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++)
+            merge_row(i, result.indices.data() + result.indptr[i],
+                      result.data.data() + result.indptr[i]);
+    });
+    return result;
+}
+
+/// Method to apply op to every stored value, dropping the values that become 0
+template <typename Op> static SparseMatrix map_values(const SparseMatrix &mat, Op op) {
+    SparseMatrix result;
+    result.rows = mat.rows;
+    result.cols = mat.cols;
+    result.indptr.assign(mat.rows + 1, 0);
+    result.indices.reserve(mat.indices.size());
+    result.data.reserve(mat.data.size());
+    for (int i = 0; i < mat.rows; i++) {
+        for (int p = mat.indptr[i]; p < mat.indptr[i + 1]; p++) {
+            double value = op(mat.data[p]);
+            if (value != 0) {
+                result.indices.push_back(mat.indices[p]);
+                result.data.push_back(value);
+            }
+        }
+        result.indptr[i + 1] = result.indices.size();
+    }
+    return result;
+}
+
+/// Method to return the number of rows
+int SparseMatrix::row_length() const { return rows; }
+
+/// Method to return the number of columns
+int SparseMatrix::col_length() const { return cols; }
+
+/// Method to return the number of stored (non-zero) values
+int SparseMatrix::nnz() const { return data.size(); }
+
+/// Method to return the value at (row, col), with a binary search in the row
+double SparseMatrix::get(int row, int col) const {
+    bool error = ((row >= 0) && (row < rows)) && ((col >= 0) && (col < cols));
+    if (!error)
+        assert(("Index is out of range", false));
+
+    auto begin = indices.begin() + indptr[row], end = indices.begin() + indptr[row + 1];
+    auto it = std::lower_bound(begin, end, col);
+    return ((it != end) && (*it == col)) ? data[it - indices.begin()] : 0;
+}
+
+/// Method to convert to a dense Matrix object
+Matrix SparseMatrix::to_dense() const {
+    Matrix mat;
+    mat.double_mat.assign(rows, std::vector<double>(cols, 0));
+    for (int i = 0; i < rows; i++)
+        for (int p = indptr[i]; p < indptr[i + 1]; p++)
+            mat.double_mat[i][indices[p]] = data[p];
+    mat.to_string();
+    return mat;
+}
+
+/// Method to convert to the compressed sparse column format
+SparseMatrixCSC SparseMatrix::to_csc() const {
+    SparseMatrixCSC result;
+    result.rows = rows;
+    result.cols = cols;
+    transpose_compressed(rows, cols, indptr, indices, data, result.indptr, result.indices,
+                         result.data);
+    return result;
+}
+
+/// Method to return the Transpose, which shares its layout with the CSC format
+SparseMatrix SparseMatrix::T() const {
+    SparseMatrix result;
+    result.rows = cols;
+    result.cols = rows;
+    transpose_compressed(rows, cols, indptr, indices, data, result.indptr, result.indices,
+                         result.data);
+    return result;
+}
+
+/// Method to return the rows [row_start, row_end)
+SparseMatrix SparseMatrix::slice(int row_start, int row_end) const {
+    bool is_within_range = (row_start >= 0) && (row_start <= row_end) && (row_end <= rows);
+    if (!is_within_range)
+        assert(("The slicing parameters are out of bounds of the matrix size.", false));
+
+    SparseMatrix result;
+    result.rows = row_end - row_start;
+    result.cols = cols;
+    result.indptr.resize(result.rows + 1);
+    for (int i = 0; i <= result.rows; i++)
+        result.indptr[i] = indptr[row_start + i] - indptr[row_start];
+    result.indices.assign(indices.begin() + indptr[row_start], indices.begin() + indptr[row_end]);
+    result.data.assign(data.begin() + indptr[row_start], data.begin() + indptr[row_end]);
+    return result;
+}
+
+/** Method to compute y = A * x for contiguous vectors x of length cols and y of length rows
+   The rows are split across threads. This is the form expected by LinearOperator, so a
+   SparseMatrix can be passed to the iterative solvers through a lambda.
+*/
+void SparseMatrix::matvec(const double *x, double *y) const {
+    kernels::parallel_for(0, rows, sparse_grain, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) {
+            double s = 0;
+            for (int p = indptr[i]; p < indptr[i + 1]; p++)
+                s += data[p] * x[indices[p]];
+            y[i] = s;
+        }
+    });
+}
+
+/// Method to add two SparseMatrix objects, the result has the union of their patterns
+SparseMatrix SparseMatrix::operator+(const SparseMatrix &mat) const {
+    return combine(*this, mat, [](double x, double y) { return x + y; }, true);
+}
+
+/// Method to subtract two SparseMatrix objects, the result has the union of their patterns
+SparseMatrix SparseMatrix::operator-(const SparseMatrix &mat) const {
+    return combine(*this, mat, [](double x, double y) { return x - y; }, true);
+}
+
+/// Method to multiply two SparseMatrix objects element-wise, only common entries are kept
+SparseMatrix SparseMatrix::operator*(const SparseMatrix &mat) const {
+    return combine(*this, mat, [](double x, double y) { return x * y; }, false);
+}
+
+/// Method to multiply every value by a scalar
+SparseMatrix SparseMatrix::operator*(double d) const {
+    return map_values(*this, [d](double x) { return x * d; });
+}
+
+/// Method to divide every stored value by a scalar
+SparseMatrix SparseMatrix::operator/(double d) const {
+    return map_values(*this, [d](double x) { return x / d; });
+}
+
+/// Method to negate every value
+SparseMatrix SparseMatrix::operator-() const {
+    return map_values(*this, [](double x) { return -x; });
+}
+
+/// Method to convert to the compressed sparse row format
+SparseMatrix SparseMatrixCSC::to_csr() const {
+    SparseMatrix result;
+    result.rows = rows;
+    result.cols = cols;
+    transpose_compressed(cols, rows, indptr, indices, data, result.indptr, result.indices,
+                         result.data);
+    return result;
+}
+
+/// Method to convert to a dense Matrix object
+Matrix SparseMatrixCSC::to_dense() const {
+    Matrix mat;
+    mat.double_mat.assign(rows, std::vector<double>(cols, 0));
+    for (int j = 0; j < cols; j++)
+        for (int p = indptr[j]; p < indptr[j + 1]; p++)
+            mat.double_mat[indices[p]][j] = data[p];
+    mat.to_string();
+    return mat;
+}
+
+/// Method to build a SparseMatrix object from the non-zero values of a Matrix object
+SparseMatrix MatrixOp::sparse(Matrix mat) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    SparseMatrix result;
+    result.rows = mat.row_length();
+    result.cols = mat.col_length();
+    result.indptr.assign(result.rows + 1, 0);
+    for (int i = 0; i < result.rows; i++) {
+        for (int j = 0; j < result.cols; j++) {
+            if (mat.double_mat[i][j] != 0) {
+                result.indices.push_back(j);
+                result.data.push_back(mat.double_mat[i][j]);
+            }
+        }
+        result.indptr[i + 1] = result.indices.size();
+    }
+    return result;
+}
+
+/// Method to multiply a SparseMatrix object by a dense Matrix object, rows split across threads
+Matrix MatrixOp::matmul(SparseMatrix mat1, Matrix mat2) {
+    bool error = mat2.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (mat1.col_length() != mat2.row_length())
+        assert(("The Matrix objects should be of compatible dimensions", false));
+
+    int m = mat1.row_length(), k = mat2.col_length();
+    std::vector<double> b = kernels::pack(mat2), c(static_cast<size_t>(m) * k, 0);
+    kernels::parallel_for(0, m, sparse_grain, [&](int i0, int i1) {
+        for (int i = i0; i < i1; i++) {
+            double *c_i = c.data() + static_cast<size_t>(i) * k;
+            for (int p = mat1.indptr[i]; p < mat1.indptr[i + 1]; p++) {
+                double a_ip = mat1.data[p];
+                const double *b_p = b.data() + static_cast<size_t>(mat1.indices[p]) * k;
+                for (int j = 0; j < k; j++)
+                    c_i[j] += a_ip * b_p[j];
+            }
+        }
+    });
+    return kernels::unpack(c, m, k);
+}
+
+/// Method to calculate the k largest eigenpairs of a symmetric SparseMatrix with Lanczos
+Eigh MatrixOp::eigsh(SparseMatrix mat, int k) {
+    if (mat.row_length() != mat.col_length())
+        assert(("The Matrix must be a square matrix", false));
+
+    LinearOperator apply = [&mat](const double *x, double *y) { mat.matvec(x, y); };
+    return eigsh(apply, mat.row_length(), k);
+}
+
+/// Method to calculate the absolute value of the stored values of a SparseMatrix object
+SparseMatrix MatrixOp::abs(SparseMatrix mat) {
+    return map_values(mat, [](double x) { return std::abs(x); });
+}
+
+/// Method to calculate the square root of the stored values of a SparseMatrix object
+SparseMatrix MatrixOp::sqrt(SparseMatrix mat) {
+    return map_values(mat, [](double x) { return std::sqrt(x); });
+}
+
+/// Method to raise the stored values of a SparseMatrix object to a positive power
+SparseMatrix MatrixOp::power(SparseMatrix mat, double exponent) {
+    if (exponent <= 0)
+        assert(("The exponent must be positive to keep the Matrix sparse", false));
+    return map_values(mat, [exponent](double x) { return std::pow(x, exponent); });
+}
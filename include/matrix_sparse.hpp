@@ -0,0 +1,58 @@
+#ifndef _matrix_sparse_hpp_
+#define _matrix_sparse_hpp_
+
+#include <matrix_basic.hpp>
+
+class SparseMatrixCSC;
+
+/** Sparse Matrix in compressed sparse row (CSR) format
+   Only the non-zero values are stored, as doubles. The column indices and values of row i are
+   indices[indptr[i]:indptr[i+1]] and data[indptr[i]:indptr[i+1]], with the column indices of a
+   row sorted and no explicit zeros.
+*/
+class SparseMatrix {
+  public:
+    int rows = 0;
+    int cols = 0;
+    std::vector<int> indptr = {0};
+    std::vector<int> indices;
+    std::vector<double> data;
+
+    // Member functions
+    int row_length() const;
+    int col_length() const;
+    int nnz() const;
+    double get(int, int) const;
+    Matrix to_dense() const;
+    SparseMatrixCSC to_csc() const;
+    SparseMatrix T() const;
+    SparseMatrix slice(int, int) const;
+    void matvec(const double *, double *) const;
+
+    // Overloaded Operators
+    SparseMatrix operator+(const SparseMatrix &) const;
+    SparseMatrix operator-(const SparseMatrix &) const;
+    SparseMatrix operator*(const SparseMatrix &) const;
+    SparseMatrix operator*(double) const;
+    SparseMatrix operator/(double) const;
+    SparseMatrix operator-() const;
+};
+
+/** Sparse Matrix in compressed sparse column (CSC) format
+   The same layout as SparseMatrix with the roles of rows and columns swapped: the row indices
+   and values of column j are indices[indptr[j]:indptr[j+1]] and data[indptr[j]:indptr[j+1]].
+*/
+class SparseMatrixCSC {
+  public:
+    int rows = 0;
+    int cols = 0;
+    std::vector<int> indptr = {0};
+    std::vector<int> indices;
+    std::vector<double> data;
+
+    // Member functions
+    SparseMatrix to_csr() const;
+    Matrix to_dense() const;
+};
+
+#endif /* _matrix_sparse_hpp_ */
@@ -0,0 +1,279 @@
+#include <matrix_kernels.hpp>
+#include <matrix_operations.hpp>
+
+#include <limits>
+
+/** Method to add the rows of a Matrix object of doubles
+   The statistics of the rows are computed on their own, with a second pass for m2, and then
+   merged, so a chunk adds no more rounding error than a whole Matrix would.
+*/
+void RunningStats::update(const Matrix &mat) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+    int rows = mat.double_mat.size();
+    if (rows == 0)
+        return;
+    int cols = mat.double_mat[0].size();
+
+    RunningStats chunk;
+    chunk.count = rows;
+    chunk.sums.assign(cols, 0);
+    chunk.m2.assign(cols, 0);
+    chunk.mins = mat.double_mat[0];
+    chunk.maxs = mat.double_mat[0];
+    for (const std::vector<double> &row : mat.double_mat) {
+        if (static_cast<int>(row.size()) != cols)
+            assert(("All the rows should have the same number of columns", false));
+        for (int j = 0; j < cols; j++) {
+            chunk.sums[j] += row[j];
+            chunk.mins[j] = std::min(chunk.mins[j], row[j]);
+            chunk.maxs[j] = std::max(chunk.maxs[j], row[j]);
+        }
+    }
+    chunk.means = chunk.sums;
+    for (double &mean : chunk.means)
+        mean /= rows;
+    for (const std::vector<double> &row : mat.double_mat)
+        for (int j = 0; j < cols; j++) {
+            double d = row[j] - chunk.means[j];
+            chunk.m2[j] += d * d;
+        }
+    merge(chunk);
+}
+
+/// Method to add the rows seen by another RunningStats object
+void RunningStats::merge(const RunningStats &other) {
+    if (other.count == 0)
+        return;
+    if (count == 0) {
+        *this = other;
+        return;
+    }
+    if (other.means.size() != means.size())
+        assert(("The RunningStats objects should have the same number of columns", false));
+
+    double n_a = count, n_b = other.count, n = n_a + n_b;
+    for (size_t j = 0; j < means.size(); j++) {
+        double delta = other.means[j] - means[j];
+        sums[j] += other.sums[j];
+        means[j] += delta * n_b / n;
+        m2[j] += other.m2[j] + delta * delta * n_a * n_b / n;
+        mins[j] = std::min(mins[j], other.mins[j]);
+        maxs[j] = std::max(maxs[j], other.maxs[j]);
+    }
+    count += other.count;
+}
+
+/// Method to get the sum of each column as a (1, cols) Matrix object
+Matrix RunningStats::sum() const { return kernels::unpack(sums, 1, sums.size()); }
+
+/// Method to get the mean of each column as a (1, cols) Matrix object
+Matrix RunningStats::mean() const { return kernels::unpack(means, 1, means.size()); }
+
+/// Method to get the variance of each column, the same as matrix.std() of all the rows
+Matrix RunningStats::var() const {
+    std::vector<double> result(m2);
+    for (double &v : result)
+        v /= count;
+    return kernels::unpack(result, 1, result.size());
+}
+
+/// Method to get the standard deviation of each column as a (1, cols) Matrix object
+Matrix RunningStats::std() const {
+    std::vector<double> result(m2);
+    for (double &v : result)
+        v = std::sqrt(v / count);
+    return kernels::unpack(result, 1, result.size());
+}
+
+/// Method to get the minimum of each column as a (1, cols) Matrix object
+Matrix RunningStats::min() const { return kernels::unpack(mins, 1, mins.size()); }
+
+/// Method to get the maximum of each column as a (1, cols) Matrix object
+Matrix RunningStats::max() const { return kernels::unpack(maxs, 1, maxs.size()); }
+
+/// Starting values of the NaN-skipping reductions
+static const double nan_inf = std::numeric_limits<double>::infinity();
+static const double nan_value = std::numeric_limits<double>::quiet_NaN();
+
+/// Number of accumulators each row is spread over in the "row" NaN-skipping reductions
+static const int nan_lanes = 4;
+
+/** Method to reduce the values of a Matrix along an axis, skipping the NaN values
+   There is one output per column for dim "column" and one per row for dim "row". acc holds N
+   fields of accumulators, all set to init first, and step(p, k, out, v, index) adds the value
+   v found at index along the axis to accumulator k of output out, where p[f] points to field
+   f. step uses selects on v == v rather than branches, so the loop over the columns of a row
+   vectorizes. Each row of a "row" reduction is spread over nan_lanes local accumulators, so it
+   is not one serial chain, and merge(p, k, l) folds accumulator l into k at the end of the row.
+*/
+template <int N, typename Step, typename Merge>
+static void nan_reduce(const Matrix &mat, const std::string &dim, const double (&init)[N],
+                       std::vector<double> (&acc)[N], Step step, Merge merge) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+    int rows = mat.double_mat.size();
+    int cols = rows ? mat.double_mat[0].size() : 0;
+    for (const std::vector<double> &row : mat.double_mat)
+        if (static_cast<int>(row.size()) != cols)
+            assert(("All the rows should have the same number of columns", false));
+
+    double *p[N];
+    if (dim == "column") {
+        for (int f = 0; f < N; f++) {
+            acc[f].assign(cols, init[f]);
+            p[f] = acc[f].data();
+        }
+        for (int i = 0; i < rows; i++) {
+            const double *row = mat.double_mat[i].data();
+            for (int j = 0; j < cols; j++)
+                step(p, j, j, row[j], i);
+        }
+    } else if (dim == "row") {
+        double lanes[N][nan_lanes], *q[N];
+        for (int f = 0; f < N; f++) {
+            acc[f].resize(rows);
+            q[f] = lanes[f];
+        }
+        for (int i = 0; i < rows; i++) {
+            const double *row = mat.double_mat[i].data();
+            for (int f = 0; f < N; f++)
+                std::fill_n(lanes[f], nan_lanes, init[f]);
+            int j = 0;
+            for (; j + nan_lanes <= cols; j += nan_lanes)
+                for (int l = 0; l < nan_lanes; l++)
+                    step(q, l, i, row[j + l], j + l);
+            for (; j < cols; j++)
+                step(q, j % nan_lanes, i, row[j], j);
+            for (int l = 1; l < nan_lanes; l++)
+                merge(q, 0, l);
+            for (int f = 0; f < N; f++)
+                acc[f][i] = lanes[f][0];
+        }
+    } else {
+        assert(("Second parameter 'dimension' wrong", false));
+    }
+}
+
+/// Method to return the outputs of a reduction along dim as a Matrix object
+static Matrix nan_result(const std::vector<double> &values, const std::string &dim) {
+    return dim == "column" ? kernels::unpack(values, 1, values.size())
+                           : kernels::unpack(values, values.size(), 1);
+}
+
+/// Method to get the number and the sum of the values that are not NaN along an axis
+static void nan_count_sum(const Matrix &mat, const std::string &dim, std::vector<double> &count,
+                          std::vector<double> &sum) {
+    std::vector<double> acc[2];
+    nan_reduce<2>(
+        mat, dim, {0, 0}, acc,
+        [](double *const *p, int k, int, double v, int) {
+            bool valid = (v == v);
+            p[0][k] += valid;
+            p[1][k] += valid ? v : 0;
+        },
+        [](double *const *p, int k, int l) {
+            p[0][k] += p[0][l];
+            p[1][k] += p[1][l];
+        });
+    count = std::move(acc[0]);
+    sum = std::move(acc[1]);
+}
+
+/// Method to get the extremum of the values that are not NaN along an axis, NaN if there is none
+template <bool Max> static Matrix nan_extremum(const Matrix &mat, const std::string &dim) {
+    const double start = Max ? -nan_inf : nan_inf;
+    auto better = [](double v, double best) { return Max ? v > best : v < best; };
+    std::vector<double> acc[2];
+    nan_reduce<2>(
+        mat, dim, {0, start}, acc,
+        [&](double *const *p, int k, int, double v, int) {
+            p[0][k] += (v == v);
+            p[1][k] = better(v, p[1][k]) ? v : p[1][k];
+        },
+        [&](double *const *p, int k, int l) {
+            p[0][k] += p[0][l];
+            p[1][k] = better(p[1][l], p[1][k]) ? p[1][l] : p[1][k];
+        });
+    for (size_t k = 0; k < acc[1].size(); k++)
+        acc[1][k] = acc[0][k] > 0 ? acc[1][k] : nan_value;
+    return nan_result(acc[1], dim);
+}
+
+/** Method to calculate the sum over an axis of a Matrix, skipping NaN values
+   An axis with only NaN values sums to 0.
+*/
+Matrix MatrixOp::nansum(const Matrix &mat, std::string dim) {
+    std::vector<double> count, sum;
+    nan_count_sum(mat, dim, count, sum);
+    return nan_result(sum, dim);
+}
+
+/** Method to calculate the mean over an axis of a Matrix, skipping NaN values
+   An axis with only NaN values has a NaN mean.
+*/
+Matrix MatrixOp::nanmean(const Matrix &mat, std::string dim) {
+    std::vector<double> count, sum;
+    nan_count_sum(mat, dim, count, sum);
+    for (size_t k = 0; k < sum.size(); k++)
+        sum[k] /= count[k];
+    return nan_result(sum, dim);
+}
+
+/** Method to calculate the standard deviation over an axis of a Matrix, skipping NaN values
+   This is the square root of the population variance of the values that are not NaN, computed
+   with a second pass over the deviations from the mean. An axis with only NaN values gives NaN.
+*/
+Matrix MatrixOp::nanstd(const Matrix &mat, std::string dim) {
+    std::vector<double> count, mean;
+    nan_count_sum(mat, dim, count, mean);
+    for (size_t k = 0; k < mean.size(); k++)
+        mean[k] /= count[k];
+    const double *means = mean.data();
+    std::vector<double> acc[1];
+    nan_reduce<1>(
+        mat, dim, {0}, acc,
+        [&](double *const *p, int k, int out, double v, int) {
+            double d = (v == v) ? v - means[out] : 0;
+            p[0][k] += d * d;
+        },
+        [](double *const *p, int k, int l) { p[0][k] += p[0][l]; });
+    for (size_t k = 0; k < mean.size(); k++)
+        acc[0][k] = std::sqrt(acc[0][k] / count[k]);
+    return nan_result(acc[0], dim);
+}
+
+/// Method to get the minimum value along an axis, skipping NaN values
+Matrix MatrixOp::nanmin(const Matrix &mat, std::string dim) {
+    return nan_extremum<false>(mat, dim);
+}
+
+/// Method to get the maximum value along an axis, skipping NaN values
+Matrix MatrixOp::nanmax(const Matrix &mat, std::string dim) {
+    return nan_extremum<true>(mat, dim);
+}
+
+/** Method to get the index of the maximum value along an axis, skipping NaN values
+   The first index is returned when the maximum appears more than once, and NaN when the axis
+   has only NaN values.
+*/
+Matrix MatrixOp::nanargmax(const Matrix &mat, std::string dim) {
+    std::vector<double> acc[2];
+    nan_reduce<2>(
+        mat, dim, {-nan_inf, nan_value}, acc,
+        [](double *const *p, int k, int, double v, int index) {
+            // The first value that is not NaN is taken even if it is -inf
+            bool better = (v > p[0][k]) | ((p[1][k] != p[1][k]) & (v == v));
+            p[0][k] = better ? v : p[0][k];
+            p[1][k] = better ? index : p[1][k];
+        },
+        [](double *const *p, int k, int l) {
+            bool better = (p[0][l] > p[0][k]) | ((p[0][l] == p[0][k]) & (p[1][l] < p[1][k])) |
+                          ((p[1][k] != p[1][k]) & (p[1][l] == p[1][l]));
+            p[0][k] = better ? p[0][l] : p[0][k];
+            p[1][k] = better ? p[1][l] : p[1][k];
+        });
+    return nan_result(acc[1], dim);
+}
@@ -0,0 +1,33 @@
+#ifndef _matrix_stats_hpp_
+#define _matrix_stats_hpp_
+
+#include <matrix_basic.hpp>
+
+/** Column statistics of the rows seen so far, mergeable across chunks
+   update() adds the rows of a Matrix object and merge() adds the rows seen by another
+   RunningStats object, so a file read in chunks, or split across threads, gives the sums,
+   means, variances and extrema of the whole Matrix. The means and the sums of squared
+   deviations m2 are combined with the pairwise formulas of Chan et al., which do not lose
+   accuracy as chunks are added.
+*/
+class RunningStats {
+  public:
+    long long count = 0;
+    std::vector<double> sums;
+    std::vector<double> means;
+    std::vector<double> m2;
+    std::vector<double> mins;
+    std::vector<double> maxs;
+
+    // Member functions
+    void update(const Matrix &);
+    void merge(const RunningStats &);
+    Matrix sum() const;
+    Matrix mean() const;
+    Matrix var() const;
+    Matrix std() const;
+    Matrix min() const;
+    Matrix max() const;
+};
+
+#endif /* _matrix_stats_hpp_ */
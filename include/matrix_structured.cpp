@@ -0,0 +1,409 @@
+#include <matrix_kernels.hpp>
+#include <matrix_operations.hpp>
+
+#include <limits>
+
+/// Method to get the offset of row i of a packed triangle
+static size_t row_start(int n, bool lower, int i) {
+    return lower ? static_cast<size_t>(i) * (i + 1) / 2
+                 : static_cast<size_t>(i) * n - static_cast<size_t>(i) * (i - 1) / 2;
+}
+
+/// Method to get the value at (i, j)
+double DiagonalMatrix::get(int i, int j) const {
+    if (i < 0 || i >= n || j < 0 || j >= n)
+        assert(("Index out of range", false));
+    return (i == j) ? diag[i] : 0;
+}
+
+/// Method to convert the DiagonalMatrix object to a Matrix object
+Matrix DiagonalMatrix::to_dense() const {
+    std::vector<double> buf(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; i++)
+        buf[static_cast<size_t>(i) * n + i] = diag[i];
+    return kernels::unpack(buf, n, n);
+}
+
+/// Method to get the value at (i, j)
+double TriangularMatrix::get(int i, int j) const {
+    if (i < 0 || i >= n || j < 0 || j >= n)
+        assert(("Index out of range", false));
+    if (lower)
+        return (j <= i) ? data[row_start(n, true, i) + j] : 0;
+    return (j >= i) ? data[row_start(n, false, i) + j - i] : 0;
+}
+
+/// Method to convert the TriangularMatrix object to a Matrix object
+Matrix TriangularMatrix::to_dense() const {
+    std::vector<double> buf(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; i++) {
+        int first = lower ? 0 : i, last = lower ? i + 1 : n;
+        std::copy(data.begin() + row_start(n, lower, i),
+                  data.begin() + row_start(n, lower, i) + (last - first),
+                  buf.begin() + static_cast<size_t>(i) * n + first);
+    }
+    return kernels::unpack(buf, n, n);
+}
+
+/// Method to get the value at (i, j)
+double SymmetricMatrix::get(int i, int j) const {
+    if (i < 0 || i >= n || j < 0 || j >= n)
+        assert(("Index out of range", false));
+    if (j > i)
+        std::swap(i, j);
+    return data[row_start(n, true, i) + j];
+}
+
+/// Method to write both triangles of a SymmetricMatrix into a contiguous row-major buffer
+static std::vector<double> symmetric_dense(const SymmetricMatrix &mat) {
+    int n = mat.n;
+    std::vector<double> buf(static_cast<size_t>(n) * n);
+    for (int i = 0; i < n; i++) {
+        const double *row = mat.data.data() + row_start(n, true, i);
+        for (int j = 0; j <= i; j++) {
+            buf[static_cast<size_t>(i) * n + j] = row[j];
+            buf[static_cast<size_t>(j) * n + i] = row[j];
+        }
+    }
+    return buf;
+}
+
+/// Method to convert the SymmetricMatrix object to a Matrix object
+Matrix SymmetricMatrix::to_dense() const { return kernels::unpack(symmetric_dense(*this), n, n); }
+
+/// Method to check a Matrix object for the structured constructors
+static void check_square(const Matrix &mat) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (mat.row_length() != mat.col_length())
+        assert(("The Matrix must be a square matrix", false));
+}
+
+/** Method to build a DiagonalMatrix object
+   A row or column vector gives the diagonal values, a square Matrix gives its diagonal.
+*/
+DiagonalMatrix MatrixOp::diag(Matrix mat) {
+    bool error = mat.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    DiagonalMatrix result;
+    int rows = mat.row_length(), cols = mat.col_length();
+    if (rows == 1 || cols == 1) {
+        result.n = rows * cols;
+        for (int k = 0; k < result.n; k++)
+            result.diag.push_back((rows == 1) ? mat.double_mat[0][k] : mat.double_mat[k][0]);
+    } else {
+        check_square(mat);
+        result.n = rows;
+        for (int i = 0; i < rows; i++)
+            result.diag.push_back(mat.double_mat[i][i]);
+    }
+    return result;
+}
+
+/// Method to build a lower TriangularMatrix object from the lower triangle of a square Matrix
+TriangularMatrix MatrixOp::tril(Matrix mat) {
+    check_square(mat);
+    TriangularMatrix result;
+    result.n = mat.row_length();
+    result.lower = true;
+    for (int i = 0; i < result.n; i++)
+        result.data.insert(result.data.end(), mat.double_mat[i].begin(),
+                           mat.double_mat[i].begin() + i + 1);
+    return result;
+}
+
+/// Method to build an upper TriangularMatrix object from the upper triangle of a square Matrix
+TriangularMatrix MatrixOp::triu(Matrix mat) {
+    check_square(mat);
+    TriangularMatrix result;
+    result.n = mat.row_length();
+    result.lower = false;
+    for (int i = 0; i < result.n; i++)
+        result.data.insert(result.data.end(), mat.double_mat[i].begin() + i,
+                           mat.double_mat[i].end());
+    return result;
+}
+
+/// Method to build a SymmetricMatrix object from the lower triangle of a square Matrix
+SymmetricMatrix MatrixOp::symmetric(Matrix mat) {
+    check_square(mat);
+    SymmetricMatrix result;
+    result.n = mat.row_length();
+    for (int i = 0; i < result.n; i++)
+        result.data.insert(result.data.end(), mat.double_mat[i].begin(),
+                           mat.double_mat[i].begin() + i + 1);
+    return result;
+}
+
+/// Method to check the right-hand side of a structured solve
+static void check_rhs(const Matrix &B, int n) {
+    bool error = B.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (B.row_length() != n)
+        assert(("The Matrix objects should be of compatible dimensions", false));
+}
+
+/// Method to scale row i of a Matrix by diag(i), without forming the diagonal Matrix
+Matrix MatrixOp::matmul(const DiagonalMatrix &D, Matrix B) {
+    check_rhs(B, D.n);
+    int cols = B.col_length();
+    std::vector<double> c = kernels::pack(B);
+    for (int i = 0; i < D.n; i++)
+        for (int j = 0; j < cols; j++)
+            c[static_cast<size_t>(i) * cols + j] *= D.diag[i];
+    return kernels::unpack(c, D.n, cols);
+}
+
+/// Method to scale column j of a Matrix by diag(j), without forming the diagonal Matrix
+Matrix MatrixOp::matmul(Matrix A, const DiagonalMatrix &D) {
+    bool error = A.if_double;
+    if (!error)
+        assert(("The Matrix should be first converted to double using to_double() method", error));
+
+    if (A.col_length() != D.n)
+        assert(("The Matrix objects should be of compatible dimensions", false));
+
+    int rows = A.row_length();
+    std::vector<double> c = kernels::pack(A);
+    for (int i = 0; i < rows; i++)
+        for (int j = 0; j < D.n; j++)
+            c[static_cast<size_t>(i) * D.n + j] *= D.diag[j];
+    return kernels::unpack(c, rows, D.n);
+}
+
+/** Method to multiply a TriangularMatrix by a Matrix
+   Only the stored triangle is read, so this takes half the flops of matmul() on the dense Matrix.
+*/
+Matrix MatrixOp::matmul(const TriangularMatrix &T, Matrix B) {
+    check_rhs(B, T.n);
+    int n = T.n, cols = B.col_length();
+    std::vector<double> b = kernels::pack(B), c(static_cast<size_t>(n) * cols, 0);
+    kernels::parallel_for(0, n, 16, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            const double *row = T.data.data() + row_start(n, T.lower, i);
+            int first = T.lower ? 0 : i, last = T.lower ? i + 1 : n;
+            double *c_row = c.data() + static_cast<size_t>(i) * cols;
+            for (int k = first; k < last; k++) {
+                double t_ik = row[k - first];
+                const double *b_row = b.data() + static_cast<size_t>(k) * cols;
+                for (int j = 0; j < cols; j++)
+                    c_row[j] += t_ik * b_row[j];
+            }
+        }
+    });
+    return kernels::unpack(c, n, cols);
+}
+
+/// Method to multiply a SymmetricMatrix by a Matrix, reading each stored value once per row
+Matrix MatrixOp::matmul(const SymmetricMatrix &S, Matrix B) {
+    check_rhs(B, S.n);
+    int n = S.n, cols = B.col_length();
+    std::vector<double> b = kernels::pack(B), c(static_cast<size_t>(n) * cols, 0);
+    kernels::parallel_for(0, n, 16, [&](int begin, int end) {
+        for (int i = begin; i < end; i++) {
+            double *c_row = c.data() + static_cast<size_t>(i) * cols;
+            for (int k = 0; k < n; k++) {
+                double s_ik = (k <= i) ? S.data[row_start(n, true, i) + k]
+                                       : S.data[row_start(n, true, k) + i];
+                const double *b_row = b.data() + static_cast<size_t>(k) * cols;
+                for (int j = 0; j < cols; j++)
+                    c_row[j] += s_ik * b_row[j];
+            }
+        }
+    });
+    return kernels::unpack(c, n, cols);
+}
+
+/// Method to check that no diagonal value is below the singularity tolerance of lu()
+static bool diagonal_singular(const std::vector<double> &values, int n,
+                              const std::function<double(int)> &diagonal) {
+    double max_abs = 0;
+    for (double value : values)
+        max_abs = std::max(max_abs, std::abs(value));
+    double tol = n * std::numeric_limits<double>::epsilon() * max_abs;
+    for (int i = 0; i < n; i++)
+        if (std::abs(diagonal(i)) <= tol)
+            return true;
+    return false;
+}
+
+/** Method to solve T * X = B in place by forward or back substitution on the packed triangle
+   x is a (n, nrhs) row-major buffer, its columns are split across threads.
+*/
+static void packed_trsm(const TriangularMatrix &T, double *x, int nrhs) {
+    int n = T.n;
+    kernels::parallel_for(0, nrhs, 64, [&](int c0, int c1) {
+        for (int step = 0; step < n; step++) {
+            int i = T.lower ? step : n - 1 - step;
+            const double *row = T.data.data() + row_start(n, T.lower, i);
+            int first = T.lower ? 0 : i, last = T.lower ? i + 1 : n;
+            double *x_i = x + static_cast<size_t>(i) * nrhs;
+            for (int k = first; k < last; k++) {
+                if (k == i)
+                    continue;
+                double t_ik = row[k - first];
+                const double *x_k = x + static_cast<size_t>(k) * nrhs;
+                for (int j = c0; j < c1; j++)
+                    x_i[j] -= t_ik * x_k[j];
+            }
+            double t_ii = row[i - first];
+            for (int j = c0; j < c1; j++)
+                x_i[j] /= t_ii;
+        }
+    });
+}
+
+/// Method to solve D * X = B by dividing row i of B by diag(i)
+Matrix MatrixOp::solve(const DiagonalMatrix &D, Matrix B) {
+    check_rhs(B, D.n);
+    if (diagonal_singular(D.diag, D.n, [&](int i) { return D.diag[i]; }))
+        assert(("The Matrix is singular", false));
+
+    int cols = B.col_length();
+    std::vector<double> x = kernels::pack(B);
+    for (int i = 0; i < D.n; i++)
+        for (int j = 0; j < cols; j++)
+            x[static_cast<size_t>(i) * cols + j] /= D.diag[i];
+    return kernels::unpack(x, D.n, cols);
+}
+
+/// Method to solve T * X = B by forward or back substitution, without any factorization
+Matrix MatrixOp::solve(const TriangularMatrix &T, Matrix B) {
+    check_rhs(B, T.n);
+    if (diagonal_singular(T.data, T.n, [&](int i) { return T.get(i, i); }))
+        assert(("The Matrix is singular", false));
+
+    int cols = B.col_length();
+    std::vector<double> x = kernels::pack(B);
+    packed_trsm(T, x.data(), cols);
+    return kernels::unpack(x, T.n, cols);
+}
+
+/** Method to factorize a SymmetricMatrix with Cholesky, or with LU if it is not positive definite
+   Same as cholesky() on the dense Matrix, without going through a Matrix object.
+*/
+static Cholesky packed_cholesky(const SymmetricMatrix &S) {
+    Cholesky result;
+    result.n = S.n;
+    result.l = symmetric_dense(S);
+    result.positive_definite = kernels::cholesky_factor(result.l.data(), S.n, S.n);
+    if (!result.positive_definite) {
+        result.l.clear();
+        result.lu.n = S.n;
+        result.lu.lu = symmetric_dense(S);
+        result.lu.piv.resize(S.n);
+        result.lu.singular =
+            kernels::lu_factor(result.lu.lu.data(), S.n, S.n, result.lu.piv.data(), result.lu.sign);
+    }
+    return result;
+}
+
+/// Method to solve A * X = B in place from the factorization of a SymmetricMatrix
+static void packed_cholesky_solve(const Cholesky &factors, double *x, int nrhs) {
+    int n = factors.n;
+    if (factors.positive_definite) {
+        kernels::trsm_lower(factors.l.data(), n, n, x, nrhs, nrhs);
+        kernels::trsm_lower_trans(factors.l.data(), n, n, x, nrhs, nrhs);
+        return;
+    }
+    if (factors.lu.singular)
+        assert(("The Matrix is singular", false));
+    kernels::lu_permute(factors.lu.piv.data(), n, x, nrhs, nrhs);
+    kernels::trsm_lower_unit(factors.lu.lu.data(), n, n, x, nrhs, nrhs);
+    kernels::trsm_upper(factors.lu.lu.data(), n, n, x, nrhs, nrhs);
+}
+
+/// Method to solve S * X = B with the Cholesky factorization, falling back to LU
+Matrix MatrixOp::solve(const SymmetricMatrix &S, Matrix B) {
+    check_rhs(B, S.n);
+    int cols = B.col_length();
+    std::vector<double> x = kernels::pack(B);
+    packed_cholesky_solve(packed_cholesky(S), x.data(), cols);
+    return kernels::unpack(x, S.n, cols);
+}
+
+/// Method to calculate the Inverse of a DiagonalMatrix, which is the reciprocal of its diagonal
+DiagonalMatrix MatrixOp::inverse(const DiagonalMatrix &D) {
+    if (diagonal_singular(D.diag, D.n, [&](int i) { return D.diag[i]; }))
+        assert(("The Matrix is singular", false));
+
+    DiagonalMatrix result = D;
+    for (double &value : result.diag)
+        value = 1 / value;
+    return result;
+}
+
+/// Method to calculate the Inverse of a TriangularMatrix, which is triangular on the same side
+TriangularMatrix MatrixOp::inverse(const TriangularMatrix &T) {
+    if (diagonal_singular(T.data, T.n, [&](int i) { return T.get(i, i); }))
+        assert(("The Matrix is singular", false));
+
+    int n = T.n;
+    std::vector<double> x(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; i++)
+        x[static_cast<size_t>(i) * n + i] = 1;
+    packed_trsm(T, x.data(), n);
+
+    TriangularMatrix result;
+    result.n = n;
+    result.lower = T.lower;
+    result.data.resize(T.data.size());
+    for (int i = 0; i < n; i++) {
+        int first = T.lower ? 0 : i, last = T.lower ? i + 1 : n;
+        std::copy(x.begin() + static_cast<size_t>(i) * n + first,
+                  x.begin() + static_cast<size_t>(i) * n + last,
+                  result.data.begin() + row_start(n, T.lower, i));
+    }
+    return result;
+}
+
+/// Method to calculate the Inverse of a SymmetricMatrix, which is symmetric too
+SymmetricMatrix MatrixOp::inverse(const SymmetricMatrix &S) {
+    int n = S.n;
+    std::vector<double> x(static_cast<size_t>(n) * n, 0);
+    for (int i = 0; i < n; i++)
+        x[static_cast<size_t>(i) * n + i] = 1;
+    packed_cholesky_solve(packed_cholesky(S), x.data(), n);
+
+    SymmetricMatrix result;
+    result.n = n;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            result.data.push_back(0.5 * (x[static_cast<size_t>(i) * n + j] +
+                                         x[static_cast<size_t>(j) * n + i]));
+    return result;
+}
+
+/// Method to calculate the Determinant of a DiagonalMatrix as the product of its diagonal
+double MatrixOp::determinant(const DiagonalMatrix &D) {
+    double result = 1;
+    for (double value : D.diag)
+        result *= value;
+    return result;
+}
+
+/// Method to calculate the Determinant of a TriangularMatrix as the product of its diagonal
+double MatrixOp::determinant(const TriangularMatrix &T) {
+    double result = 1;
+    for (int i = 0; i < T.n; i++)
+        result *= T.get(i, i);
+    return result;
+}
+
+/// Method to calculate the Determinant of a SymmetricMatrix from its Cholesky factor
+double MatrixOp::determinant(const SymmetricMatrix &S) {
+    Cholesky factors = packed_cholesky(S);
+    if (!factors.positive_definite)
+        return factors.lu.determinant();
+
+    double result = 1;
+    for (int i = 0; i < S.n; i++)
+        result *= factors.l[static_cast<size_t>(i) * S.n + i];
+    return result * result;
+}
@@ -0,0 +1,48 @@
+#ifndef _matrix_structured_hpp_
+#define _matrix_structured_hpp_
+
+#include <matrix_basic.hpp>
+
+/** Diagonal Matrix of size (n, n)
+   Only the n diagonal values are stored.
+*/
+class DiagonalMatrix {
+  public:
+    int n = 0;
+    std::vector<double> diag;
+
+    // Member functions
+    double get(int, int) const;
+    Matrix to_dense() const;
+};
+
+/** Lower or upper triangular Matrix of size (n, n) in packed storage
+   The n * (n + 1) / 2 values of the triangle are stored row after row. Row i of a lower
+   triangular Matrix holds columns 0..i and starts at i * (i + 1) / 2, row i of an upper
+   triangular Matrix holds columns i..n-1 and starts at i * n - i * (i - 1) / 2.
+*/
+class TriangularMatrix {
+  public:
+    int n = 0;
+    bool lower = true;
+    std::vector<double> data;
+
+    // Member functions
+    double get(int, int) const;
+    Matrix to_dense() const;
+};
+
+/** Symmetric Matrix of size (n, n) in packed storage
+   Only the lower triangle is stored, with the layout of a lower TriangularMatrix.
+*/
+class SymmetricMatrix {
+  public:
+    int n = 0;
+    std::vector<double> data;
+
+    // Member functions
+    double get(int, int) const;
+    Matrix to_dense() const;
+};
+
+#endif /* _matrix_structured_hpp_ */
@@ -1,6 +1,23 @@
 #include "gtest/gtest.h"
 #include <Matrix.hpp>
+#include <atomic>
 #include <cmath>
+#include <cstdlib>
+#include <new>
+
+// Every allocation of the test binary is counted, so a test can check that a loop does not allocate
+static std::atomic<long> allocations{0};
+
+void *operator new(std::size_t size) {
+    allocations++;
+    if (void *p = std::malloc(size ? size : 1))
+        return p;
+    throw std::bad_alloc();
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
 
 namespace {
 
@@ -56,6 +73,47 @@ TEST_F(MatrixAlgebraTest, MatrixMultiplication) {
     EXPECT_EQ(mat_mul, test_with);
 }
 
+TEST_F(MatrixAlgebraTest, MatrixMultiplicationNonFinite) {
+    // A zero of A times Inf or NaN in B is NaN and must not be skipped
+    double inf = std::numeric_limits<double>::infinity();
+    Matrix with_inf = matrix.matmul(matrix.init(std::vector<std::vector<double>>{{0, 1}}),
+                                    matrix.init(std::vector<std::vector<double>>{{inf}, {1}}));
+    EXPECT_TRUE(std::isnan(with_inf.double_mat[0][0]));
+    Matrix with_nan =
+        matrix.matmul(matrix.init(std::vector<std::vector<double>>{{0}}),
+                      matrix.init(std::vector<std::vector<double>>{{std::nan("")}}));
+    EXPECT_TRUE(std::isnan(with_nan.double_mat[0][0]));
+}
+
+TEST_F(MatrixAlgebraTest, MultiDot) {
+    // Shapes where the written order costs far more than A * (B * (C * D))
+    std::vector<std::vector<double>> a(300, std::vector<double>(4)), b(4, std::vector<double>(300)),
+        c(300, std::vector<double>(3)), d(3, std::vector<double>(2));
+    for (int i = 0; i < 300; i++) {
+        for (int j = 0; j < 4; j++) {
+            a[i][j] = std::sin(i * 0.3 + j);
+            b[j][i] = std::cos(i * 0.7 - j);
+        }
+        for (int j = 0; j < 3; j++)
+            c[i][j] = (i % 7) - j;
+    }
+    for (int i = 0; i < 3; i++)
+        for (int j = 0; j < 2; j++)
+            d[i][j] = i + 2 * j + 1;
+    Matrix A = matrix.init(a), B = matrix.init(b), C = matrix.init(c), D = matrix.init(d);
+    std::vector<std::vector<double>> chain = matrix.multi_dot({A, B, C, D}).get();
+    std::vector<std::vector<double>> nested =
+        matrix.matmul(matrix.matmul(matrix.matmul(A, B), C), D).get();
+    ASSERT_EQ(chain.size(), 300);
+    ASSERT_EQ(chain[0].size(), 2);
+    for (int i = 0; i < 300; i++)
+        for (int j = 0; j < 2; j++)
+            EXPECT_NEAR(chain[i][j], nested[i][j], 1e-9 * (1 + std::abs(nested[i][j])));
+
+    EXPECT_EQ(matrix.multi_dot({mat, mat.T()}), matrix.matmul(mat, mat.T()));
+    EXPECT_EQ(matrix.multi_dot({mat}), mat);
+}
+
 TEST_F(MatrixAlgebraTest, Determinant) {
     Matrix sq_mat = mat.slice(0, mat.row_length(), 0, 2);
     double det = matrix.determinant(sq_mat, sq_mat.col_length());
@@ -78,4 +136,503 @@ TEST_F(MatrixAlgebraTest, Inverse) {
     EXPECT_TRUE(CheckNear(inv, test_with, 0.00001));
 }
 
+TEST_F(MatrixAlgebraTest, InverseLarge) {
+    int n = 100;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : 1.0 / (i + j + 1);
+    Matrix sq_mat = matrix.init(vec);
+    Matrix inv = matrix.inverse(sq_mat);
+    std::vector<std::vector<double>> prod = matrix.matmul(sq_mat, inv).get();
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            EXPECT_NEAR(prod[i][j], (i == j) ? 1 : 0, 1e-9);
+}
+
+TEST_F(MatrixAlgebraTest, DeterminantLarge) {
+    int n = 12;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    for (int i = 0; i < n; i++) {
+        vec[i][i] = 2;
+        for (int j = i + 1; j < n; j++)
+            vec[i][j] = j - i;
+    }
+    std::swap(vec[0], vec[n - 1]);
+    Matrix sq_mat = matrix.init(vec);
+    double det = matrix.determinant(sq_mat, n);
+    EXPECT_NEAR(det, -std::pow(2, n), 1e-6);
+}
+
+TEST_F(MatrixAlgebraTest, Solve) {
+    Matrix sq_mat = mat.slice(0, mat.row_length(), 0, 2);
+    Matrix b = mat.slice(0, mat.row_length(), 2, 3);
+    Matrix x = matrix.solve(sq_mat, b);
+    std::vector<std::vector<double>> vec;
+    vec.push_back(std::vector<double>(1, -1));
+    vec.push_back(std::vector<double>(1, 2));
+    Matrix test_with = matrix.init(vec);
+    EXPECT_TRUE(CheckNear(x, test_with, 1e-12));
+}
+
+TEST_F(MatrixAlgebraTest, SolveMixed) {
+    int n = 200;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n)), rhs(n, std::vector<double>(2));
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + ((i == j) ? 20 : 0);
+        rhs[i][0] = std::cos(i * 0.1);
+        rhs[i][1] = i;
+    }
+    Matrix A = matrix.init(vec), B = matrix.init(rhs);
+    SolveMixed mixed = matrix.solve_mixed(A, B);
+    EXPECT_FALSE(mixed.fallback);
+    EXPECT_GE(mixed.iterations, 1);
+    EXPECT_LE(mixed.iterations, 5);
+    std::vector<std::vector<double>> x = mixed.X.get(), x_double = matrix.solve(A, B).get();
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < 2; j++)
+            EXPECT_NEAR(x[i][j], x_double[i][j], 1e-13 * (1 + std::abs(x_double[i][j])));
+
+    // The Hilbert Matrix is too ill-conditioned for the single precision factors
+    int m = 10;
+    std::vector<std::vector<double>> hilbert(m, std::vector<double>(m));
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < m; j++)
+            hilbert[i][j] = 1.0 / (i + j + 1);
+    Matrix H = matrix.init(hilbert), b = matrix.ones(m, 1);
+    SolveMixed fallback = matrix.solve_mixed(H, b);
+    EXPECT_TRUE(fallback.fallback);
+    EXPECT_EQ(fallback.X.get(), matrix.solve(H, b).get());
+}
+
+TEST_F(MatrixAlgebraTest, SolveReuseFactorization) {
+    int n = 80;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : std::sin(i + 2 * j);
+    Matrix A = matrix.init(vec);
+    LU factors = matrix.lu(A);
+    for (int k = 1; k <= 3; k++) {
+        std::vector<std::vector<double>> b(n, std::vector<double>(k));
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < k; j++)
+                b[i][j] = i - j;
+        Matrix x = factors.solve(matrix.init(b));
+        std::vector<std::vector<double>> Ax = matrix.matmul(A, x).get();
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < k; j++)
+                EXPECT_NEAR(Ax[i][j], b[i][j], 1e-9);
+    }
+}
+
+TEST_F(MatrixAlgebraTest, LUMultithreaded) {
+    int n = 300;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+    Matrix A = matrix.init(vec);
+
+    int threads = matrix.get_num_threads();
+    matrix.set_num_threads(1);
+    LU serial = matrix.lu(A);
+    matrix.set_num_threads(4);
+    LU tasks = matrix.lu(A);
+    matrix.set_num_threads(threads);
+
+    EXPECT_EQ(tasks.piv, serial.piv);
+    EXPECT_EQ(tasks.sign, serial.sign);
+    EXPECT_FALSE(tasks.singular);
+    for (size_t i = 0; i < serial.lu.size(); i++)
+        EXPECT_NEAR(tasks.lu[i], serial.lu[i], 1e-12);
+
+    std::vector<std::vector<double>> l = tasks.L().get(), u = tasks.U().get();
+    std::vector<std::vector<double>> pa = vec;
+    for (int i = 0; i < n; i++)
+        std::swap(pa[i], pa[tasks.piv[i]]);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double LU_ij = 0;
+            for (int p = 0; p <= std::min(i, j); p++)
+                LU_ij += l[i][p] * u[p][j];
+            EXPECT_NEAR(LU_ij, pa[i][j], 1e-10);
+        }
+    }
+}
+
+TEST_F(MatrixAlgebraTest, ConjugateGradient) {
+    // 2D Laplacian on a 15 x 15 grid
+    int g = 15, n = g * g;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n, 0));
+    std::vector<std::vector<double>> rhs(n, std::vector<double>(1));
+    for (int i = 0; i < g; i++) {
+        for (int j = 0; j < g; j++) {
+            int k = i * g + j;
+            vec[k][k] = 4;
+            if (i > 0)
+                vec[k][k - g] = vec[k - g][k] = -1;
+            if (j > 0)
+                vec[k][k - 1] = vec[k - 1][k] = -1;
+            rhs[k][0] = std::sin(k * 0.1);
+        }
+    }
+    Matrix A = matrix.init(vec), b = matrix.init(rhs);
+    std::vector<std::vector<double>> expected = matrix.solve(A, b).get();
+
+    CG plain = matrix.cg(A, b, 1e-10, 1000);
+    CG jacobi = matrix.cg(A, b, 1e-10, 1000, "jacobi");
+    CG ichol = matrix.cg(A, b, 1e-10, 1000, "ichol");
+    for (CG result : {plain, jacobi, ichol}) {
+        EXPECT_TRUE(result.converged);
+        EXPECT_LE(result.residual, 1e-10);
+        std::vector<std::vector<double>> x = result.x.get();
+        for (int k = 0; k < n; k++)
+            EXPECT_NEAR(x[k][0], expected[k][0], 1e-8);
+    }
+    EXPECT_LT(ichol.iterations, plain.iterations);
+
+    // The same system as a matrix-free stencil, with 4 threads
+    int threads = matrix.get_num_threads();
+    matrix.set_num_threads(4);
+    LinearOperator laplacian = [g](const double *x, double *y) {
+        for (int i = 0; i < g; i++) {
+            for (int j = 0; j < g; j++) {
+                int k = i * g + j;
+                y[k] = 4 * x[k] - ((i > 0) ? x[k - g] : 0) - ((i < g - 1) ? x[k + g] : 0) -
+                       ((j > 0) ? x[k - 1] : 0) - ((j < g - 1) ? x[k + 1] : 0);
+            }
+        }
+    };
+    CG free = matrix.cg(laplacian, b, 1e-10, 1000);
+    matrix.set_num_threads(threads);
+    EXPECT_EQ(free.iterations, plain.iterations);
+    std::vector<std::vector<double>> x = free.x.get();
+    for (int k = 0; k < n; k++)
+        EXPECT_NEAR(x[k][0], expected[k][0], 1e-8);
+
+    CG capped = matrix.cg(A, b, 1e-10, 3);
+    EXPECT_FALSE(capped.converged);
+    EXPECT_EQ(capped.iterations, 3);
+
+    // On one thread the iterations do not allocate, so 50 of them allocate as much as 5
+    matrix.set_num_threads(1);
+    for (std::string preconditioner : {"none", "jacobi", "ichol"}) {
+        long before = allocations;
+        matrix.cg(A, b, 1e-300, 5, preconditioner);
+        long few = allocations - before;
+        before = allocations;
+        EXPECT_EQ(matrix.cg(A, b, 1e-300, 50, preconditioner).iterations, 50);
+        EXPECT_EQ(allocations - before, few) << preconditioner;
+    }
+    long before = allocations;
+    matrix.cg(laplacian, b, 1e-300, 5);
+    long few = allocations - before;
+    before = allocations;
+    matrix.cg(laplacian, b, 1e-300, 50);
+    EXPECT_EQ(allocations - before, few);
+    matrix.set_num_threads(threads);
+}
+
+TEST_F(MatrixAlgebraTest, Cholesky) {
+    int n = 150;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : std::exp(-std::abs(i - j) / 4.0);
+    Matrix A = matrix.init(vec);
+    Cholesky factors = matrix.cholesky(A);
+    ASSERT_TRUE(factors.positive_definite);
+    std::vector<std::vector<double>> L = factors.L().get();
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j <= i; j++) {
+            double LLt_ij = 0;
+            for (int p = 0; p <= j; p++)
+                LLt_ij += L[i][p] * L[j][p];
+            EXPECT_NEAR(LLt_ij, vec[i][j], 1e-9);
+        }
+        EXPECT_EQ(L[0][i], (i == 0) ? L[0][0] : 0);
+    }
+
+    Matrix b = matrix.ones(n, 2);
+    std::vector<std::vector<double>> Ax = matrix.matmul(A, matrix.cho_solve(factors, b)).get();
+    for (int i = 0; i < n; i++)
+        EXPECT_NEAR(Ax[i][1], 1, 1e-9);
+    EXPECT_NEAR(matrix.logdet(A), matrix.lu(A).logdet(), 1e-8);
+}
+
+TEST_F(MatrixAlgebraTest, CholeskyNotPositiveDefinite) {
+    Matrix sq_mat = mat.slice(0, mat.row_length(), 0, 2);
+    Cholesky factors = matrix.cholesky(sq_mat);
+    EXPECT_FALSE(factors.positive_definite);
+    Matrix b = mat.slice(0, mat.row_length(), 2, 3);
+    std::vector<std::vector<double>> vec;
+    vec.push_back(std::vector<double>(1, -1));
+    vec.push_back(std::vector<double>(1, 2));
+    EXPECT_TRUE(CheckNear(factors.solve(b), matrix.init(vec), 1e-12));
+}
+
+TEST_F(MatrixAlgebraTest, CholeskyMultithreaded) {
+    int n = 200;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = (i == j) ? n : std::cos(i * j);
+    Matrix A = matrix.init(vec);
+    int threads = matrix.get_num_threads();
+    matrix.set_num_threads(1);
+    std::vector<double> serial = matrix.cholesky(A).l;
+    matrix.set_num_threads(4);
+    std::vector<double> parallel = matrix.cholesky(A).l;
+    matrix.set_num_threads(threads);
+    EXPECT_EQ(serial, parallel);
+}
+
+TEST_F(MatrixAlgebraTest, QR) {
+    int m = 150, n = 90;
+    std::vector<std::vector<double>> vec(m, std::vector<double>(n));
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin(i * 0.37 + j * 1.3) + ((i == j) ? 2 : 0);
+    QR factors = matrix.qr(matrix.init(vec));
+    Matrix Q = factors.Q();
+    Matrix R = factors.R();
+    EXPECT_EQ(Q.row_length(), m);
+    EXPECT_EQ(Q.col_length(), n);
+    std::vector<std::vector<double>> q = Q.get(), r = R.get();
+    std::vector<std::vector<double>> QR = matrix.matmul(Q, R).get();
+    for (int i = 0; i < m; i++)
+        for (int j = 0; j < n; j++)
+            EXPECT_NEAR(QR[i][j], vec[i][j], 1e-10);
+    for (int i = 0; i < n; i++) {
+        for (int j = 0; j < n; j++) {
+            double QtQ_ij = 0;
+            for (int p = 0; p < m; p++)
+                QtQ_ij += q[p][i] * q[p][j];
+            EXPECT_NEAR(QtQ_ij, (i == j) ? 1 : 0, 1e-12);
+        }
+        for (int j = 0; j < i; j++)
+            EXPECT_EQ(r[i][j], 0);
+    }
+}
+
+TEST_F(MatrixAlgebraTest, Lstsq) {
+    int m = 3000, n = 6;
+    std::vector<std::vector<double>> x(m, std::vector<double>(n)), y(m, std::vector<double>(2));
+    for (int i = 0; i < m; i++) {
+        for (int j = 0; j < n; j++)
+            x[i][j] = (j == 0) ? 1 : std::cos(i * (j + 0.5));
+        y[i][0] = 1 + 2 * x[i][1] - 3 * x[i][5];
+        y[i][1] = y[i][0] + ((i % 2) ? 0.5 : -0.5);
+    }
+    Matrix X = matrix.init(x), Y = matrix.init(y);
+
+    int threads = matrix.get_num_threads();
+    for (int t : {1, 4}) {
+        matrix.set_num_threads(t);
+        Lstsq fit = matrix.lstsq(X, Y);
+        std::vector<std::vector<double>> coef = fit.coef.get();
+        std::vector<double> expected = {1, 2, 0, 0, 0, -3};
+        for (int j = 0; j < n; j++)
+            EXPECT_NEAR(coef[j][0], expected[j], 1e-10);
+        EXPECT_NEAR(fit.residuals.get()[0][0], 0, 1e-18 * m);
+
+        std::vector<std::vector<double>> pred = matrix.matmul(X, fit.coef).get();
+        double rss = 0;
+        for (int i = 0; i < m; i++)
+            rss += (pred[i][1] - y[i][1]) * (pred[i][1] - y[i][1]);
+        EXPECT_NEAR(fit.residuals.get()[0][1], rss, 1e-9 * rss);
+    }
+    matrix.set_num_threads(threads);
+}
+
+TEST_F(MatrixAlgebraTest, Eigh) {
+    int n = 100;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j <= i; j++)
+            vec[i][j] = vec[j][i] = std::sin(i * 0.7 + j * 0.7) + std::cos(i * j * 0.01);
+    Matrix A = matrix.init(vec);
+
+    int threads = matrix.get_num_threads();
+    for (int t : {1, 4}) {
+        matrix.set_num_threads(t);
+        Eigh full = matrix.eigh(A);
+        std::vector<std::vector<double>> w = full.values.get(), v = full.vectors.get();
+        EXPECT_EQ(full.vectors.col_length(), n);
+        for (int j = 0; j < n; j++) {
+            if (j > 0)
+                EXPECT_GE(w[0][j - 1], w[0][j]);
+            for (int i = 0; i < n; i++) {
+                double Av_ij = 0;
+                for (int p = 0; p < n; p++)
+                    Av_ij += vec[i][p] * v[p][j];
+                EXPECT_NEAR(Av_ij, w[0][j] * v[i][j], 1e-10);
+            }
+            for (int l = 0; l <= j; l++) {
+                double VtV_jl = 0;
+                for (int p = 0; p < n; p++)
+                    VtV_jl += v[p][j] * v[p][l];
+                EXPECT_NEAR(VtV_jl, (j == l) ? 1 : 0, 1e-10);
+            }
+        }
+
+        int k = 5;
+        Eigh top = matrix.eigh(A, k);
+        std::vector<std::vector<double>> w_k = top.values.get(), v_k = top.vectors.get();
+        EXPECT_EQ(top.vectors.col_length(), k);
+        for (int j = 0; j < k; j++) {
+            EXPECT_NEAR(w_k[0][j], w[0][j], 1e-10);
+            for (int i = 0; i < n; i++) {
+                double Av_ij = 0;
+                for (int p = 0; p < n; p++)
+                    Av_ij += vec[i][p] * v_k[p][j];
+                EXPECT_NEAR(Av_ij, w_k[0][j] * v_k[i][j], 1e-10);
+            }
+            for (int l = 0; l <= j; l++) {
+                double VtV_jl = 0;
+                for (int p = 0; p < n; p++)
+                    VtV_jl += v_k[p][j] * v_k[p][l];
+                EXPECT_NEAR(VtV_jl, (j == l) ? 1 : 0, 1e-10);
+            }
+        }
+    }
+    matrix.set_num_threads(threads);
+}
+
+TEST_F(MatrixAlgebraTest, Eigsh) {
+    int n = 400, k = 4;
+    std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = std::sin((i + j) * 0.37) + std::cos((i - j) * 0.05) + (i == j) * i * 0.01;
+    Matrix A = matrix.init(vec);
+    Eigh full = matrix.eigh(A, k);
+    int threads = matrix.get_num_threads();
+    for (int t : {1, 4}) {
+        matrix.set_num_threads(t);
+        Eigh top = matrix.eigsh(A, k);
+        ASSERT_EQ(top.values.col_length(), k);
+        ASSERT_EQ(top.vectors.row_length(), n);
+        std::vector<std::vector<double>> values = top.values.get(), vectors = top.vectors.get();
+        std::vector<std::vector<double>> full_values = full.values.get();
+        std::vector<std::vector<double>> Av = matrix.matmul(A, top.vectors).get();
+        for (int j = 0; j < k; j++) {
+            EXPECT_NEAR(values[0][j], full_values[0][j], 1e-8 * std::abs(full_values[0][0]));
+            for (int i = 0; i < n; i++)
+                EXPECT_NEAR(Av[i][j], values[0][j] * vectors[i][j], 1e-6);
+            for (int l = 0; l < k; l++) {
+                double dot = 0;
+                for (int i = 0; i < n; i++)
+                    dot += vectors[i][j] * vectors[i][l];
+                EXPECT_NEAR(dot, (j == l), 1e-10);
+            }
+        }
+    }
+    matrix.set_num_threads(threads);
+
+    // Same eigenvalues through an operator and a SparseMatrix
+    LinearOperator apply = [&](const double *x, double *y) {
+        for (int i = 0; i < n; i++) {
+            y[i] = 0;
+            for (int j = 0; j < n; j++)
+                y[i] += vec[i][j] * x[j];
+        }
+    };
+    std::vector<std::vector<double>> op_values = matrix.eigsh(apply, n, k).values.get();
+    std::vector<std::vector<double>> sparse_values = matrix.eigsh(matrix.sparse(A), k).values.get();
+    std::vector<std::vector<double>> expected = full.values.get();
+    for (int j = 0; j < k; j++) {
+        EXPECT_NEAR(op_values[0][j], expected[0][j], 1e-8 * std::abs(expected[0][0]));
+        EXPECT_NEAR(sparse_values[0][j], expected[0][j], 1e-8 * std::abs(expected[0][0]));
+    }
+
+    // A Matrix of rank 2 has an invariant Krylov subspace of size 2
+    Eigh low_rank = matrix.eigsh(matrix.matmul(matrix.ones(n, 2), matrix.ones(2, n)), 1);
+    EXPECT_NEAR(low_rank.values.get()[0][0], 2 * n, 1e-9 * n);
+}
+
+TEST_F(MatrixAlgebraTest, SVD) {
+    int threads = matrix.get_num_threads();
+    for (std::pair<int, int> shape : {std::make_pair(130, 70), std::make_pair(40, 90)}) {
+        int m = shape.first, n = shape.second, r = std::min(m, n);
+        std::vector<std::vector<double>> vec(m, std::vector<double>(n));
+        for (int i = 0; i < m; i++)
+            for (int j = 0; j < n; j++)
+                vec[i][j] = std::sin(i * 0.37 + j * 1.3) + std::cos(i * j * 0.05);
+        Matrix A = matrix.init(vec);
+
+        for (int t : {1, 4}) {
+            matrix.set_num_threads(t);
+            SVD full = matrix.svd(A);
+            std::vector<std::vector<double>> u = full.U.get(), s = full.S.get(), v = full.V.get();
+            EXPECT_EQ(full.U.row_length(), m);
+            EXPECT_EQ(full.U.col_length(), r);
+            EXPECT_EQ(full.V.row_length(), n);
+            for (int i = 0; i < m; i++) {
+                for (int j = 0; j < n; j++) {
+                    double USVt_ij = 0;
+                    for (int p = 0; p < r; p++)
+                        USVt_ij += u[i][p] * s[0][p] * v[j][p];
+                    EXPECT_NEAR(USVt_ij, vec[i][j], 1e-10);
+                }
+            }
+            for (int j = 1; j < r; j++)
+                EXPECT_GE(s[0][j - 1], s[0][j]);
+
+            int k = 4;
+            SVD top = matrix.svd(A, k);
+            std::vector<std::vector<double>> s_k = top.S.get(), u_k = top.U.get();
+            std::vector<std::vector<double>> v_k = top.V.get();
+            for (int j = 0; j < k; j++) {
+                EXPECT_NEAR(s_k[0][j], s[0][j], 1e-10 * s[0][0]);
+                for (int i = 0; i < m; i++) {
+                    double Av_ij = 0;
+                    for (int p = 0; p < n; p++)
+                        Av_ij += vec[i][p] * v_k[p][j];
+                    EXPECT_NEAR(Av_ij, s_k[0][j] * u_k[i][j], 1e-8);
+                }
+            }
+        }
+    }
+    matrix.set_num_threads(threads);
+}
+
+TEST_F(MatrixAlgebraTest, RandomizedSVD) {
+    int m = 300, n = 200, rank = 8;
+    std::vector<std::vector<double>> vec(m, std::vector<double>(n, 0));
+    for (int r = 0; r < rank; r++)
+        for (int i = 0; i < m; i++)
+            for (int j = 0; j < n; j++)
+                vec[i][j] +=
+                    std::pow(0.5, r) * std::sin(i * (r + 1) * 0.1) * std::cos(j * (r + 2) * 0.07);
+    Matrix A = matrix.init(vec);
+
+    int k = 5;
+    SVD exact = matrix.svd(A, k);
+    SVD approx = matrix.randomized_svd(A, k, 10, 2, 42);
+    std::vector<std::vector<double>> s = exact.S.get(), s_r = approx.S.get();
+    std::vector<std::vector<double>> u_r = approx.U.get(), v_r = approx.V.get();
+    EXPECT_EQ(approx.U.row_length(), m);
+    EXPECT_EQ(approx.U.col_length(), k);
+    EXPECT_EQ(approx.V.row_length(), n);
+    for (int j = 0; j < k; j++) {
+        EXPECT_NEAR(s_r[0][j], s[0][j], 1e-10 * s[0][0]);
+        for (int i = 0; i < m; i++) {
+            double Av_ij = 0;
+            for (int p = 0; p < n; p++)
+                Av_ij += vec[i][p] * v_r[p][j];
+            EXPECT_NEAR(Av_ij, s_r[0][j] * u_r[i][j], 1e-9);
+        }
+    }
+
+    int threads = matrix.get_num_threads();
+    matrix.set_num_threads(4);
+    SVD again = matrix.randomized_svd(A, k, 10, 2, 42);
+    EXPECT_EQ(again.S.get(), approx.S.get());
+    EXPECT_EQ(again.U.get(), approx.U.get());
+    matrix.set_num_threads(threads);
+}
+
 } // namespace
\ No newline at end of file
@@ -0,0 +1,91 @@
+#include "gtest/gtest.h"
+#include <Matrix.hpp>
+
+namespace {
+
+class MatrixBatchTest : public ::testing::Test {
+  protected:
+    int count = 700, n = 4;
+    std::vector<double> tensor;
+    MatrixBatch batch;
+
+    MatrixBatchTest() {
+        tensor.resize(count * n * n);
+        for (int b = 0; b < count; b++)
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < n; j++)
+                    tensor[(b * n + i) * n + j] = std::sin(b * 0.7 + i * 1.3 + j * j) + (i == j);
+        // Matrix 5 has two equal rows, matrix 6 needs a row swap at the first step
+        for (int j = 0; j < n; j++) {
+            tensor[(5 * n + 1) * n + j] = tensor[(5 * n + 2) * n + j];
+            tensor[(6 * n + 0) * n + j] = (j == 1);
+            tensor[(6 * n + 1) * n + j] = (j == 0);
+        }
+        batch = matrix.batch(tensor, count, n, n);
+    }
+
+    Matrix single(int b) {
+        std::vector<std::vector<double>> vec(n, std::vector<double>(n));
+        for (int i = 0; i < n; i++)
+            for (int j = 0; j < n; j++)
+                vec[i][j] = tensor[(b * n + i) * n + j];
+        return matrix.init(vec);
+    }
+};
+
+TEST_F(MatrixBatchTest, Layout) {
+    EXPECT_EQ(batch.tensor(), tensor);
+    EXPECT_EQ(batch.get(3).get(), single(3).get());
+    MatrixBatch from_matrices = matrix.batch({single(0), single(1), single(2)});
+    EXPECT_EQ(from_matrices.count, 3);
+    EXPECT_EQ(from_matrices.get(2).get(), single(2).get());
+}
+
+TEST_F(MatrixBatchTest, Determinant) {
+    int threads = matrix.get_num_threads();
+    for (int t : {1, 4}) {
+        matrix.set_num_threads(t);
+        std::vector<double> det = matrix.determinant(batch);
+        ASSERT_EQ(det.size(), count);
+        for (int b = 0; b < count; b++)
+            EXPECT_NEAR(det[b], matrix.lu(single(b)).determinant(), 1e-10);
+        EXPECT_NEAR(det[5], 0, 1e-12);
+    }
+    matrix.set_num_threads(threads);
+}
+
+TEST_F(MatrixBatchTest, InverseAndSolve) {
+    int threads = matrix.get_num_threads();
+    for (int t : {1, 4}) {
+        matrix.set_num_threads(t);
+        MatrixBatch inv = matrix.inverse(batch);
+        MatrixBatch identity = matrix.matmul(batch, inv);
+        for (int b = 0; b < count; b++) {
+            if (b == 5)
+                continue;
+            std::vector<std::vector<double>> product = identity.get(b).get();
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < n; j++)
+                    EXPECT_NEAR(product[i][j], (i == j), 1e-9);
+        }
+        EXPECT_TRUE(std::isnan(inv.get(5).get()[0][0]));
+
+        std::vector<double> rhs(count * n * 2);
+        for (int k = 0; k < count * n * 2; k++)
+            rhs[k] = std::cos(k * 0.3);
+        MatrixBatch B = matrix.batch(rhs, count, n, 2);
+        MatrixBatch X = matrix.solve(batch, B);
+        EXPECT_EQ(X.rows, n);
+        EXPECT_EQ(X.cols, 2);
+        for (int b : {0, 6, 311, count - 1}) {
+            std::vector<std::vector<double>> x = X.get(b).get(),
+                                             x_single = matrix.solve(single(b), B.get(b)).get();
+            for (int i = 0; i < n; i++)
+                for (int j = 0; j < 2; j++)
+                    EXPECT_NEAR(x[i][j], x_single[i][j], 1e-9 * (1 + std::abs(x_single[i][j])));
+        }
+    }
+    matrix.set_num_threads(threads);
+}
+
+} // namespace
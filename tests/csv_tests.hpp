@@ -0,0 +1,340 @@
+#include "gtest/gtest.h"
+#include <Matrix.hpp>
+#include <cmath>
+#include <cstdio>
+
+namespace {
+
+class MatrixCsvTest : public ::testing::Test {
+  protected:
+    std::string path = ::testing::TempDir() + "matrix_csv_test.csv";
+
+    void write(const std::string &text) {
+        std::ofstream file(path, std::ios::binary);
+        file << text;
+    }
+
+    ~MatrixCsvTest() { std::remove(path.c_str()); }
+};
+
+TEST_F(MatrixCsvTest, StringCells) {
+    Matrix mat = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
+    std::ifstream file("./datasets/boston/boston.csv");
+    std::string line, cell;
+    std::vector<std::vector<std::string>> expected;
+    while (std::getline(file, line)) {
+        std::stringstream ss(line);
+        std::vector<std::string> cells;
+        while (std::getline(ss, cell, ','))
+            cells.push_back(cell);
+        expected.push_back(cells);
+    }
+    EXPECT_EQ(mat.str_mat, expected);
+    EXPECT_FALSE(mat.if_double);
+}
+
+TEST_F(MatrixCsvTest, QuotesAndLineEndings) {
+    write("\"a,b\",1\r\n\r\n\"say \"\"hi\"\"\",2\n3,\n\"multi\nline\",4");
+    Matrix mat = matrix.genfromtxt(path, ',');
+    std::vector<std::vector<std::string>> expected = {
+        {"a,b", "1"}, {"say \"hi\"", "2"}, {"3", ""}, {"multi\nline", "4"}};
+    EXPECT_EQ(mat.str_mat, expected);
+}
+
+TEST_F(MatrixCsvTest, BlankLinesAndMissingFile) {
+    // Blank lines give no row and a trailing delimiter ends the line with an empty cell
+    write("1,2\n\n\n3,\n,4\n");
+    Matrix mat = matrix.genfromtxt(path, ',');
+    std::vector<std::vector<std::string>> expected = {{"1", "2"}, {"3", ""}, {"", "4"}};
+    EXPECT_EQ(mat.str_mat, expected);
+    EXPECT_EQ(mat.col_length(), 2);
+
+    ASSERT_DEATH(matrix.genfromtxt(path + ".missing", ','), "The file could not be opened");
+}
+
+TEST_F(MatrixCsvTest, Numeric) {
+    // Long rows so that cells cross the 64 byte blocks of the scanner
+    std::string text = "x0;x1;x2;x3;x4;x5;x6;x7;x8;x9;x10;x11\n";
+    std::vector<std::vector<double>> values(300, std::vector<double>(12));
+    char cell[32];
+    for (int i = 0; i < 300; i++) {
+        for (int j = 0; j < 12; j++) {
+            values[i][j] = std::sin(i * 12 + j) * std::pow(10, (i + j) % 9 - 4);
+            std::snprintf(cell, sizeof(cell), "%.17g", values[i][j]);
+            text += std::string(j ? ";" : "") + ((j == 3) ? " " : "") + cell;
+        }
+        text += "\n";
+    }
+    write(text);
+    Matrix mat = matrix.genfromtxt(path, ';', 1);
+    EXPECT_TRUE(mat.if_double);
+    EXPECT_EQ(mat.row_length(), 300);
+    EXPECT_EQ(mat.col_length(), 12);
+    EXPECT_EQ(mat.get(), values);
+
+    Matrix boston = matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1);
+    Matrix expected = matrix.genfromtxt("./datasets/boston/boston.csv", ',');
+    expected = expected.slice(1, expected.row_length(), 0, expected.col_length());
+    expected.to_double();
+    EXPECT_EQ(boston.str_mat, expected.str_mat);
+    EXPECT_EQ(boston.get(), expected.get());
+}
+
+TEST_F(MatrixCsvTest, ParallelRanges) {
+    // Over 1 MB with most of the bytes inside quoted fields, so that cuts land inside them
+    std::string text;
+    std::vector<std::vector<std::string>> expected;
+    std::vector<std::vector<double>> values;
+    for (int i = 0; i < 6000; i++) {
+        std::string field;
+        for (int k = 0; k < 8; k++)
+            field += "line " + std::to_string(i) + ",\"" + std::to_string(k) + "\"\n";
+        std::string quoted;
+        for (char c : field)
+            quoted += (c == '"') ? std::string("\"\"") : std::string(1, c);
+        text += std::to_string(i) + ",\"" + quoted + "\"," + std::to_string(i * 0.5) + "\r\n";
+        expected.push_back({std::to_string(i), field, std::to_string(i * 0.5)});
+    }
+    write(text);
+    int threads = matrix.get_num_threads();
+    matrix.set_num_threads(4);
+    Matrix mat = matrix.genfromtxt(path, ',');
+    matrix.set_num_threads(threads);
+    EXPECT_EQ(mat.str_mat, expected);
+
+    text.clear();
+    for (int i = 0; i < 100000; i++) {
+        text += "\"" + std::to_string(i * 0.5) + "\"\n";
+        values.push_back({i * 0.5});
+    }
+    write(text);
+    for (int t : {1, 3, 8}) {
+        Matrix numeric = matrix.genfromtxt(path, ',', 0, t);
+        EXPECT_EQ(numeric.get(), values);
+    }
+
+    // A quote inside an unquoted cell is plain text and must not shift the later cuts
+    text = "id,height,note\n0,5'10\",plain\n";
+    for (int i = 1; i < 40000; i++)
+        text += std::to_string(i) + ",\"a\nb\",\"c,d\"\n";
+    write(text);
+    CsvOptions options;
+    options.names = true;
+    options.dtypes = {"double", "string", "string"};
+    for (int t : {1, 4}) {
+        options.threads = t;
+        CsvTable table = matrix.genfromtxt(path, options);
+        ASSERT_EQ(table.data.row_length(), 40000);
+        EXPECT_EQ(table.strings[0][0], "5'10\"");
+        EXPECT_EQ(table.strings[0][39999], "a\nb");
+        EXPECT_EQ(table.strings[1][39999], "c,d");
+        EXPECT_EQ(table.data.double_mat[39999][0], 39999);
+    }
+}
+
+TEST_F(MatrixCsvTest, TypedColumns) {
+    CsvOptions options;
+    options.names = true;
+    CsvTable iris = matrix.genfromtxt("./datasets/iris/iris.csv", options);
+    std::vector<std::string> dtypes = {"double", "double", "double", "double", "double", "string"};
+    EXPECT_EQ(iris.dtypes, dtypes);
+    EXPECT_EQ(iris.names[0], "sepal length (cm)");
+    EXPECT_EQ(iris.names[5], "label");
+    EXPECT_EQ(iris.data.row_length(), 150);
+    EXPECT_EQ(iris.data.col_length(), 5);
+    ASSERT_EQ(iris.strings.size(), 1u);
+    EXPECT_EQ(iris.strings[0].front(), "setosa");
+    EXPECT_EQ(iris.strings[0].back(), "virginica");
+
+    Matrix expected = matrix.genfromtxt("./datasets/iris/iris.csv", ',');
+    expected = expected.slice(1, expected.row_length(), 0, 5);
+    expected.to_double();
+    EXPECT_EQ(iris.data.get(), expected.get());
+    EXPECT_EQ(iris.column("petal width (cm)").get(), expected.slice(0, 150, 3, 4).get());
+    EXPECT_EQ(iris.column("label").str_mat[50][0], "versicolor");
+
+    // Kept columns in the asked order, with a numeric column read as strings
+    write("id,name,score\n7,\"b, c\",1.5\n8,d,2.5\n");
+    options.usecols = {2, 0, 1};
+    options.dtypes = {"", "string", ""};
+    CsvTable table = matrix.genfromtxt(path, options);
+    EXPECT_EQ(table.names, std::vector<std::string>({"score", "id", "name"}));
+    EXPECT_EQ(table.dtypes, std::vector<std::string>({"double", "string", "string"}));
+    EXPECT_EQ(table.data.get(), std::vector<std::vector<double>>({{1.5}, {2.5}}));
+    EXPECT_EQ(table.strings[0], std::vector<std::string>({"7", "8"}));
+    EXPECT_EQ(table.strings[1], std::vector<std::string>({"b, c", "d"}));
+
+    options = CsvOptions();
+    options.delim = ';';
+    options.skip_header = 1;
+    write("# comment\n1;x\n2;y\n");
+    table = matrix.genfromtxt(path, options);
+    EXPECT_EQ(table.names, std::vector<std::string>({"0", "1"}));
+    EXPECT_EQ(table.data.get(), std::vector<std::vector<double>>({{1}, {2}}));
+    EXPECT_EQ(table.strings[0], std::vector<std::string>({"x", "y"}));
+}
+
+TEST_F(MatrixCsvTest, Filters) {
+    Matrix all = matrix.genfromtxt("./datasets/iris/iris.csv", ',');
+    std::vector<std::vector<double>> expected;
+    for (int i = 1; i < all.row_length(); i++)
+        if (all.str_mat[i][5] == "versicolor" && std::stod(all.str_mat[i][3]) > 1.5)
+            expected.push_back({std::stod(all.str_mat[i][3]), std::stod(all.str_mat[i][0])});
+    ASSERT_FALSE(expected.empty());
+
+    CsvOptions options;
+    options.names = true;
+    options.usecols = {3, 0};
+    options.filters = {{5, "==", "versicolor"}, {3, ">", "1.5"}};
+    CsvTable table = matrix.genfromtxt("./datasets/iris/iris.csv", options);
+    EXPECT_EQ(table.names, std::vector<std::string>({"petal width (cm)", "sepal length (cm)"}));
+    EXPECT_EQ(table.data.get(), expected);
+    EXPECT_EQ(table.data.str_mat.size(), expected.size());
+
+    // A row failing a numeric filter on a text cell is dropped, strings are compared as text
+    write("a,x\n1,q\nb,r\n3,\"s\"\n");
+    options = CsvOptions();
+    options.dtypes = {"string", "string"};
+    options.filters = {{0, ">=", "1"}, {1, "!=", "q"}};
+    table = matrix.genfromtxt(path, options);
+    EXPECT_EQ(table.strings[0], std::vector<std::string>({"3"}));
+    EXPECT_EQ(table.strings[1], std::vector<std::string>({"s"}));
+    options.filters = {{1, "<", "r"}};
+    table = matrix.genfromtxt(path, options);
+    EXPECT_EQ(table.strings[1], std::vector<std::string>({"q"}));
+}
+
+TEST_F(MatrixCsvTest, ChunkReader) {
+    std::string text = "a,b,c\n";
+    char cell[64];
+    for (int i = 0; i < 1000; i++) {
+        std::snprintf(cell, sizeof(cell), "%d,%.17g,%.17g\n", i, std::sin(i) * 1e3, 1e8 + i % 7);
+        text += cell;
+    }
+    write(text);
+    Matrix whole = matrix.genfromtxt(path, ',', 1);
+
+    CsvChunkReader reader(path, ',', 1, 128);
+    Matrix chunk;
+    RunningStats stats;
+    std::vector<std::vector<double>> rows;
+    std::vector<const std::vector<double> *> buffers;
+    while (reader.next(chunk)) {
+        EXPECT_EQ(chunk.col_length(), 3);
+        rows.insert(rows.end(), chunk.double_mat.begin(), chunk.double_mat.end());
+        buffers.push_back(chunk.double_mat.data());
+        stats.update(chunk);
+    }
+    EXPECT_FALSE(reader.next(chunk));
+    ASSERT_EQ(buffers.size(), 8u);
+    EXPECT_EQ(chunk.row_length(), 1000 - 7 * 128);
+    EXPECT_EQ(rows, whole.get());
+    // The two buffers are traded back and forth, so the rows are not allocated again
+    EXPECT_EQ(buffers[2], buffers[0]);
+    EXPECT_EQ(buffers[3], buffers[1]);
+
+    EXPECT_EQ(stats.count, 1000);
+    EXPECT_EQ(stats.min().get(), matrix.min(whole, "column").get());
+    EXPECT_EQ(stats.max().get(), matrix.max(whole, "column").get());
+    std::vector<double> sum = matrix.sum(whole, "column").get_row(0);
+    std::vector<double> mean = matrix.mean(whole, "column").get_row(0);
+    std::vector<double> var = matrix.std(whole, "column").get_row(0);
+    for (int j = 0; j < 3; j++) {
+        EXPECT_NEAR(stats.sum().get_row(0)[j], sum[j], 1e-12 * std::abs(sum[j]));
+        EXPECT_NEAR(stats.mean().get_row(0)[j], mean[j], 1e-12 * std::abs(mean[j]));
+        EXPECT_NEAR(stats.var().get_row(0)[j], var[j], 1e-9 * var[j]);
+        EXPECT_NEAR(stats.std().get_row(0)[j], std::sqrt(var[j]), 1e-9 * std::sqrt(var[j]));
+    }
+
+    // Merging the statistics of two halves gives the same result
+    RunningStats first, second;
+    first.update(whole.slice(0, 300, 0, 3));
+    second.update(whole.slice(300, 1000, 0, 3));
+    first.merge(second);
+    EXPECT_EQ(first.count, 1000);
+    EXPECT_EQ(first.max().get(), stats.max().get());
+    for (int j = 0; j < 3; j++)
+        EXPECT_NEAR(first.var().get_row(0)[j], var[j], 1e-9 * var[j]);
+}
+
+TEST_F(MatrixCsvTest, SaveText) {
+    std::vector<std::vector<double>> values;
+    for (int i = 0; i < 10000; i++)
+        values.push_back({double(i), std::sin(i) * 1e3, 1 / (i + 3.0), std::exp(i % 700 - 350.0)});
+    values[1] = {0.1, -0.0, std::numeric_limits<double>::max(),
+                 std::numeric_limits<double>::denorm_min()};
+    values[2] = {-2.2250738585072014e-308, 1e21, 123456789012345678.0, -1.0 / 3};
+    Matrix mat = matrix.init(values);
+    matrix.savetxt(mat, path, ',', "a,b,c,d");
+    std::ifstream file(path);
+    std::string line;
+    std::getline(file, line);
+    EXPECT_EQ(line, "a,b,c,d");
+    std::getline(file, line);
+    std::getline(file, line);
+    EXPECT_EQ(line, "0.1,-0,1.7976931348623157e+308,5e-324");
+    file.close();
+    EXPECT_EQ(matrix.genfromtxt(path, ',', 1).get(), values);
+
+    // No header line is written when the header is empty
+    std::vector<std::vector<double>> small = {{1.5, 2}, {3, 4}};
+    matrix.savetxt(matrix.init(small), path, ';', "");
+    EXPECT_EQ(matrix.genfromtxt(path, ';', 0).get(), small);
+
+    std::vector<std::vector<std::string>> cells = {
+        {"a,b", "say \"hi\""}, {"multi\nline", ""}, {"plain", "\"x"}};
+    Matrix strings;
+    strings.str_mat = cells;
+    matrix.savetxt(strings, path, ',', "");
+    EXPECT_EQ(matrix.genfromtxt(path, ',').str_mat, cells);
+}
+
+TEST_F(MatrixCsvTest, MissingValues) {
+    write("a,b,c\n1,NA,x\n,2,y\n3,4,\"NA\"\n5,,z\n");
+    CsvOptions options;
+    options.names = true;
+    options.missing = {"", "NA"};
+    options.mask = true;
+    CsvTable table = matrix.genfromtxt(path, options);
+    EXPECT_EQ(table.dtypes, std::vector<std::string>({"double", "double", "string"}));
+    std::vector<std::vector<bool>> expected = {{1, 0}, {0, 1}, {1, 1}, {1, 0}};
+    for (int i = 0; i < 4; i++)
+        for (int j = 0; j < 2; j++) {
+            EXPECT_EQ(table.is_valid(i, j), expected[i][j]);
+            EXPECT_EQ(std::isnan(table.data.double_mat[i][j]), !expected[i][j]);
+        }
+    EXPECT_EQ(table.valid, std::vector<uint64_t>({0b01111001}));
+    EXPECT_EQ(table.strings[0][2], "NA");
+    EXPECT_EQ(table.data.str_mat[1][0], "nan");
+    EXPECT_EQ(matrix.nansum(table.data, "column").get(),
+              (std::vector<std::vector<double>>{{9, 6}}));
+
+    // The gaps of rejected rows are not kept in the mask
+    options.filters = {{2, "!=", "y"}};
+    table = matrix.genfromtxt(path, options);
+    EXPECT_EQ(table.data.row_length(), 3);
+    EXPECT_EQ(table.valid, std::vector<uint64_t>({0b011101}));
+    options.filters.clear();
+
+    // Without a mask the missing values are only NaN
+    options.mask = false;
+    table = matrix.genfromtxt(path, options);
+    EXPECT_TRUE(table.valid.empty());
+    EXPECT_FALSE(table.is_valid(1, 0));
+    EXPECT_TRUE(table.is_valid(1, 1));
+
+    // Many rows over several threads
+    std::string text;
+    for (int i = 0; i < 100000; i++)
+        text += (i % 7 == 0) ? "NA,1\n" : std::to_string(i) + ",1\n";
+    write(text);
+    options.names = false;
+    options.mask = true;
+    options.threads = 4;
+    table = matrix.genfromtxt(path, options);
+    ASSERT_EQ(table.data.row_length(), 100000);
+    for (int i = 0; i < 100000; i++)
+        ASSERT_EQ(table.is_valid(i, 0), i % 7 != 0);
+}
+
+} // namespace
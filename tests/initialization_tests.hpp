@@ -128,4 +128,27 @@ TEST(MatrixInitTest, InitializesMatrixFromDouble) {
 
     EXPECT_EQ(mat, test_with);
 }
-} // namespace
\ No newline at end of file
+
+TEST(MatrixInitTest, ConvertsBetweenStringsAndDoubles) {
+    std::vector<std::vector<double>> values = {{1e-9, 0.1, -2.5}, {1.0 / 3, 1e300, 0}};
+    Matrix mat = matrix.init(values);
+    std::vector<std::vector<std::string>> expected = {{"1e-09", "0.1", "-2.5"},
+                                                      {"0.3333333333333333", "1e+300", "0"}};
+    EXPECT_EQ(mat.str_mat, expected);
+    mat.to_double();
+    EXPECT_EQ(mat.get(), values);
+
+    Matrix strings;
+    strings.str_mat = {{" +1.5", "x", "2"}, {"", "3e2", "4abc"}};
+    std::vector<std::pair<int, int>> bad;
+    EXPECT_FALSE(strings.to_double(bad));
+    EXPECT_EQ(bad, (std::vector<std::pair<int, int>>{{0, 1}, {1, 0}, {1, 2}}));
+    EXPECT_EQ(strings.double_mat[0][0], 1.5);
+    EXPECT_EQ(strings.double_mat[1][1], 300);
+    EXPECT_TRUE(std::isnan(strings.double_mat[1][2]));
+    strings.str_mat = {{"1", "2"}};
+    EXPECT_TRUE(strings.to_double(bad));
+    EXPECT_TRUE(bad.empty());
+    EXPECT_EQ(strings.get(), (std::vector<std::vector<double>>{{1, 2}}));
+}
+} // namespace
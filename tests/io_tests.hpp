@@ -0,0 +1,163 @@
+#include "gtest/gtest.h"
+#include <Matrix.hpp>
+#include <cstdio>
+#include <cstring>
+
+namespace {
+
+class MatrixIoTest : public ::testing::Test {
+  protected:
+    std::string path = ::testing::TempDir() + "matrix_io_test.bin";
+
+    // Bytes of a version 1.0 .npy file
+    static std::string npy(const std::string &dict, const std::string &payload) {
+        std::string header = dict;
+        header.append((64 - (10 + header.size() + 1) % 64) % 64, ' ');
+        header.push_back('\n');
+        std::string bytes = "\x93NUMPY";
+        bytes += {1, 0, static_cast<char>(header.size() & 0xff),
+                  static_cast<char>(header.size() >> 8)};
+        return bytes + header + payload;
+    }
+
+    template <typename T> static std::string raw(std::vector<T> values, bool reversed) {
+        std::string bytes;
+        for (T value : values) {
+            char b[sizeof(T)];
+            std::memcpy(b, &value, sizeof(T));
+            if (reversed)
+                std::reverse(b, b + sizeof(T));
+            bytes.append(b, sizeof(T));
+        }
+        return bytes;
+    }
+
+    void write(const std::string &text) {
+        std::ofstream file(path, std::ios::binary);
+        file << text;
+    }
+
+    ~MatrixIoTest() { std::remove(path.c_str()); }
+};
+
+TEST_F(MatrixIoTest, BinarySaveLoad) {
+    Matrix boston = matrix.genfromtxt("./datasets/boston/boston.csv", ',', 1);
+    matrix.save(boston, path);
+    MatrixView view = matrix.load(path);
+    EXPECT_EQ(view.rows, boston.row_length());
+    EXPECT_EQ(view.cols, boston.col_length());
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(view.data) % 64, 0u);
+    EXPECT_EQ(view.get(3, 5), boston.double_mat[3][5]);
+    EXPECT_EQ(view.to_matrix().get(), boston.get());
+    EXPECT_TRUE(view.verify());
+
+    // The view keeps the file mapped after the first copy is gone
+    MatrixView copy = view;
+    view = MatrixView();
+    EXPECT_EQ(copy.get(505, 13), boston.double_mat[505][13]);
+
+    // A value changed on disk is caught by verify()
+    {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(64 + 8 * 100);
+        double value = -1;
+        file.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+    EXPECT_FALSE(matrix.load(path).verify());
+
+    matrix.save(matrix.init(std::vector<std::vector<double>>()), path);
+    EXPECT_EQ(matrix.load(path).rows, 0);
+    EXPECT_TRUE(matrix.load(path).verify());
+}
+
+TEST_F(MatrixIoTest, BinaryHeaderOverflow) {
+    matrix.save(matrix.init(std::vector<std::vector<double>>{{1, 2}}), path);
+    auto set_shape = [&](uint64_t rows, uint64_t cols) {
+        std::fstream file(path, std::ios::binary | std::ios::in | std::ios::out);
+        file.seekp(24);
+        file.write(reinterpret_cast<const char *>(&rows), sizeof(rows));
+        file.write(reinterpret_cast<const char *>(&cols), sizeof(cols));
+    };
+    set_shape(uint64_t(1) << 40, 1);
+    ASSERT_DEATH(matrix.load(path), "The binary Matrix file has too many rows or columns");
+    // rows * cols * 8 wraps around 64 bits, which must not pass the size check
+    set_shape(std::numeric_limits<int>::max(), std::numeric_limits<int>::max());
+    ASSERT_DEATH(matrix.load(path), "The binary Matrix file is truncated");
+}
+
+TEST_F(MatrixIoTest, Npy) {
+    Matrix mat = matrix.init(std::vector<std::vector<double>>{{1.5, -2, 3}, {4, 5, 6e300}});
+    matrix.save_npy(mat, path);
+    MatrixView view = matrix.load_npy(path);
+    EXPECT_EQ(view.rows, 2);
+    EXPECT_EQ(view.cols, 3);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(view.data) % 64, 0u);
+    EXPECT_EQ(view.to_matrix().get(), mat.get());
+    // A .npy file has no checksum to compare with
+    EXPECT_FALSE(view.has_checksum);
+    EXPECT_TRUE(view.verify());
+
+    // Fortran ordered float32 is converted to a row-major copy
+    write(npy("{'descr': '<f4', 'fortran_order': True, 'shape': (2, 3), }",
+              raw<float>({1, 4, 2, 5, 3, 6}, false)));
+    EXPECT_EQ(matrix.load_npy(path).to_matrix().get(),
+              std::vector<std::vector<double>>({{1, 2, 3}, {4, 5, 6}}));
+
+    // Big-endian doubles, 1-d integers, unsigned bytes and a 0-d array
+    write(npy("{'descr': '>f8', 'fortran_order': False, 'shape': (1, 2), }",
+              raw<double>({0.25, -3}, true)));
+    EXPECT_EQ(matrix.load_npy(path).to_matrix().get(),
+              std::vector<std::vector<double>>({{0.25, -3}}));
+    write(npy("{'descr': '<i4', 'fortran_order': False, 'shape': (3,), }",
+              raw<int32_t>({-7, 0, 2147483647}, false)));
+    EXPECT_EQ(matrix.load_npy(path).to_matrix().get(),
+              std::vector<std::vector<double>>({{-7, 0, 2147483647}}));
+    write(npy("{'descr': '|u1', 'fortran_order': False, 'shape': (2, 1), }",
+              raw<uint8_t>({255, 3}, false)));
+    EXPECT_EQ(matrix.load_npy(path).to_matrix().get(),
+              std::vector<std::vector<double>>({{255}, {3}}));
+    write(npy("{'descr': '<i8', 'fortran_order': False, 'shape': (), }",
+              raw<int64_t>({-42}, false)));
+    EXPECT_EQ(matrix.load_npy(path).get(0, 0), -42);
+}
+
+TEST_F(MatrixIoTest, Npz) {
+    Matrix a = matrix.init(std::vector<std::vector<double>>{{1, 2}, {3, 4}, {5, 6}});
+    Matrix b = matrix.init(std::vector<double>{7.5, -1, 0});
+    matrix.save_npz({{"a", a}, {"weights", b}}, path);
+    std::map<std::string, MatrixView> arrays = matrix.load_npz(path);
+    ASSERT_EQ(arrays.size(), 2u);
+    EXPECT_EQ(arrays["a"].to_matrix().get(), a.get());
+    EXPECT_EQ(arrays["weights"].to_matrix().get(), b.get());
+    // The arrays are aligned in the archive, so they are read in place
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arrays["a"].data) % 64, 0u);
+    EXPECT_EQ(reinterpret_cast<uintptr_t>(arrays["weights"].data) % 64, 0u);
+}
+
+TEST_F(MatrixIoTest, NpzTruncatedDirectory) {
+    matrix.save_npz({{"a", matrix.init(std::vector<double>{1, 2})}}, path);
+    std::string bytes;
+    {
+        std::ifstream file(path, std::ios::binary);
+        bytes.assign(std::istreambuf_iterator<char>(file), std::istreambuf_iterator<char>());
+    }
+    size_t entry = bytes.find(std::string("PK\x01\x02", 4));
+    ASSERT_NE(entry, std::string::npos);
+
+    // A name longer than the rest of the file
+    std::string bad = bytes;
+    bad[entry + 28] = bad[entry + 29] = '\xff';
+    write(bad);
+    ASSERT_DEATH(matrix.load_npz(path), "The .npz file is truncated");
+
+    // A ZIP64 extra field too short for the values it should hold
+    bad = bytes;
+    bad.replace(entry + 20, 4, "\xff\xff\xff\xff");
+    size_t name_len = static_cast<unsigned char>(bad[entry + 28]);
+    bad.insert(entry + 46 + name_len, std::string("\x01\x00\x00\x00", 4));
+    bad[entry + 30] = 4;
+    write(bad);
+    ASSERT_DEATH(matrix.load_npz(path), "The .npz file is truncated");
+}
+
+} // namespace
@@ -98,6 +98,7 @@ TEST_F(MatrixLogicalOpTest, LessThanOperation5) {
     test_with.to_double();
     test_with = test_with.slice(0, 1, 0, test_with.col_length());
     test_with(0, 0) = 5;
+    test_with.to_string();
     EXPECT_TRUE(mat < test_with);
 }
 
@@ -105,6 +106,7 @@ TEST_F(MatrixLogicalOpTest, LessThanOperation6) {
     Matrix test_with = matrix.genfromtxt("./tests/test_dataset.csv", ',');
     test_with.to_double();
     test_with(0, 0) = 5;
+    test_with.to_string();
     EXPECT_TRUE(mat < test_with);
 }
 
@@ -166,6 +168,7 @@ TEST_F(MatrixLogicalOpTest, LessThanEqualOperation5) {
     test_with.to_double();
     test_with = test_with.slice(0, 1, 0, test_with.col_length());
     test_with(0, 0) = 5;
+    test_with.to_string();
     EXPECT_TRUE(mat <= test_with);
 }
 
@@ -173,6 +176,7 @@ TEST_F(MatrixLogicalOpTest, LessThanEqualOperation6) {
     Matrix test_with = matrix.genfromtxt("./tests/test_dataset.csv", ',');
     test_with.to_double();
     test_with(0, 0) = 5;
+    test_with.to_string();
     EXPECT_TRUE(mat <= test_with);
 }
 
@@ -244,6 +248,7 @@ TEST_F(MatrixLogicalOpTest, GreaterThanOperation5) {
     test_with.to_double();
     test_with = test_with.slice(0, 1, 0, test_with.col_length());
     test_with(0, 0) = 5;
+    test_with.to_string();
     EXPECT_FALSE(mat > test_with);
 }
 
@@ -251,6 +256,7 @@ TEST_F(MatrixLogicalOpTest, GreaterThanOperation6) {
     Matrix test_with = matrix.genfromtxt("./tests/test_dataset.csv", ',');
     test_with.to_double();
     test_with(0, 0) = 5;
+    test_with.to_string();
     EXPECT_FALSE(mat > test_with);
 }
 
@@ -312,6 +318,7 @@ TEST_F(MatrixLogicalOpTest, GreaterThanEqualOperation5) {
     test_with.to_double();
     test_with = test_with.slice(0, 1, 0, test_with.col_length());
     test_with(0, 0) = 5;
+    test_with.to_string();
     EXPECT_FALSE(mat >= test_with);
 }
 
@@ -319,6 +326,7 @@ TEST_F(MatrixLogicalOpTest, GreaterThanEqualOperation6) {
     Matrix test_with = matrix.genfromtxt("./tests/test_dataset.csv", ',');
     test_with.to_double();
     test_with(0, 0) = 5;
+    test_with.to_string();
     EXPECT_FALSE(mat >= test_with);
 }
 
@@ -50,6 +50,36 @@ TEST_F(MatrixMiscTest, ConcatenateRow) {
     EXPECT_EQ(concat, test_with);
 }
 
+TEST_F(MatrixMiscTest, Block) {
+    Matrix I = matrix.eye(2), Z = matrix.zeros(2, 3);
+    Matrix assembled = matrix.block({{mat, I}, {Z, matrix.ones(2, 2)}});
+    std::vector<std::vector<double>> vec = {
+        {1, 2, 3, 1, 0}, {4, 5, 6, 0, 1}, {0, 0, 0, 1, 1}, {0, 0, 0, 1, 1}};
+    EXPECT_EQ(assembled, matrix.init(vec));
+    EXPECT_EQ(assembled.get(), vec);
+    EXPECT_EQ(matrix.block({{mat, mat}}), matrix.concatenate(mat, mat, "column"));
+    EXPECT_EQ(matrix.block({{mat}, {mat}}), matrix.concatenate(mat, mat, "row"));
+}
+
+TEST_F(MatrixMiscTest, Kron) {
+    Matrix kron = matrix.kron(matrix.eye(2), mat);
+    std::vector<std::vector<double>> vec = {
+        {1, 2, 3, 0, 0, 0}, {4, 5, 6, 0, 0, 0}, {0, 0, 0, 1, 2, 3}, {0, 0, 0, 4, 5, 6}};
+    EXPECT_EQ(kron, matrix.init(vec));
+
+    Matrix kron2 = matrix.kron(mat, matrix.init(std::vector<std::vector<double>>{{1, -1}}));
+    EXPECT_EQ(kron2.get(),
+              (std::vector<std::vector<double>>{{1, -1, 2, -2, 3, -3}, {4, -4, 5, -5, 6, -6}}));
+}
+
+TEST_F(MatrixMiscTest, Outer) {
+    Matrix u = matrix.init(std::vector<std::vector<double>>{{1}, {2}});
+    Matrix v = matrix.init(std::vector<double>{3, 4, 5});
+    std::vector<std::vector<double>> vec = {{3, 4, 5}, {6, 8, 10}};
+    EXPECT_EQ(matrix.outer(u, v), matrix.init(vec));
+    EXPECT_EQ(matrix.outer(u.T(), v).get(), vec);
+}
+
 TEST_F(MatrixMiscTest, Get) {
     std::vector<std::vector<double>> get_vec = mat.get();
     std::vector<std::vector<double>> test_with;
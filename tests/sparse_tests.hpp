@@ -0,0 +1,101 @@
+#include "gtest/gtest.h"
+#include <Matrix.hpp>
+
+namespace {
+
+class SparseMatrixTest : public ::testing::Test {
+  protected:
+    std::vector<std::vector<double>> vec;
+    Matrix dense;
+    SparseMatrix sparse;
+
+    SparseMatrixTest() {
+        int rows = 600, cols = 40;
+        vec.assign(rows, std::vector<double>(cols, 0));
+        for (int i = 0; i < rows; i++)
+            for (int j = 0; j < cols; j++)
+                if ((i * 7 + j * 3) % 11 == 0)
+                    vec[i][j] = i - 2.5 * j;
+        dense = matrix.init(vec);
+        sparse = matrix.sparse(dense);
+    }
+};
+
+TEST_F(SparseMatrixTest, DenseConversion) {
+    EXPECT_EQ(sparse.row_length(), 600);
+    EXPECT_EQ(sparse.col_length(), 40);
+    int nnz = 0;
+    for (std::vector<double> &row : vec)
+        for (double value : row)
+            nnz += (value != 0);
+    EXPECT_EQ(sparse.nnz(), nnz);
+    EXPECT_EQ(sparse.to_dense().get(), vec);
+    EXPECT_EQ(sparse.get(7, 0), vec[7][0]);
+    EXPECT_EQ(sparse.get(7, 1), 0);
+}
+
+TEST_F(SparseMatrixTest, CSCConversion) {
+    SparseMatrixCSC csc = sparse.to_csc();
+    EXPECT_EQ(csc.indptr.size(), 41);
+    EXPECT_EQ(csc.to_dense().get(), vec);
+    SparseMatrix csr = csc.to_csr();
+    EXPECT_EQ(csr.indptr, sparse.indptr);
+    EXPECT_EQ(csr.indices, sparse.indices);
+    EXPECT_EQ(csr.data, sparse.data);
+    EXPECT_EQ(sparse.T().to_dense().get(), dense.T().get());
+}
+
+TEST_F(SparseMatrixTest, Matmul) {
+    std::vector<std::vector<double>> rhs(40, std::vector<double>(3));
+    for (int i = 0; i < 40; i++)
+        for (int j = 0; j < 3; j++)
+            rhs[i][j] = std::sin(i + j);
+    Matrix B = matrix.init(rhs);
+    std::vector<std::vector<double>> expected = matrix.matmul(dense, B).get();
+
+    int threads = matrix.get_num_threads();
+    for (int t : {1, 4}) {
+        matrix.set_num_threads(t);
+        std::vector<std::vector<double>> result = matrix.matmul(sparse, B).get();
+        for (int i = 0; i < 600; i++)
+            for (int j = 0; j < 3; j++)
+                EXPECT_NEAR(result[i][j], expected[i][j], 1e-12);
+
+        std::vector<double> x = B.get_col(0), y(600);
+        sparse.matvec(x.data(), y.data());
+        for (int i = 0; i < 600; i++)
+            EXPECT_NEAR(y[i], expected[i][0], 1e-12);
+    }
+    matrix.set_num_threads(threads);
+}
+
+TEST_F(SparseMatrixTest, ElementWiseOperations) {
+    SparseMatrix shifted = matrix.sparse(dense * 0.5);
+    EXPECT_EQ((sparse + shifted).to_dense().get(), (dense + dense * 0.5).get());
+    EXPECT_EQ((sparse * shifted).to_dense().get(), (dense * dense * 0.5).get());
+    EXPECT_EQ((sparse - sparse).nnz(), 0);
+    EXPECT_EQ((sparse * 0.0).nnz(), 0);
+    EXPECT_EQ((-sparse).to_dense().get(), (-dense).get());
+    EXPECT_EQ((sparse / 2).to_dense().get(), (dense / 2).get());
+    EXPECT_EQ(matrix.abs(sparse).to_dense().get(), matrix.abs(dense).get());
+    EXPECT_EQ(matrix.power(sparse, 2).to_dense().get(), matrix.power(dense, 2).get());
+    EXPECT_EQ(matrix.abs(sparse).nnz(), sparse.nnz());
+}
+
+TEST_F(SparseMatrixTest, Slice) {
+    SparseMatrix rows = sparse.slice(100, 250);
+    EXPECT_EQ(rows.row_length(), 150);
+    EXPECT_EQ(rows.to_dense().get(), std::vector<std::vector<double>>(vec.begin() + 100,
+                                                                       vec.begin() + 250));
+    EXPECT_EQ(sparse.slice(5, 5).nnz(), 0);
+}
+
+TEST_F(SparseMatrixTest, Genfromtxt) {
+    SparseMatrix mat = matrix.genfromtxt_sparse("./tests/test_dataset.csv", ',', 0);
+    EXPECT_EQ(mat.row_length(), 2);
+    EXPECT_EQ(mat.col_length(), 3);
+    EXPECT_EQ(mat.to_dense().get(), std::vector<std::vector<double>>({{1, 2, 3}, {4, 5, 6}}));
+    EXPECT_EQ(matrix.genfromtxt_sparse("./tests/test_dataset.csv", ',', 1).row_length(), 1);
+}
+
+} // namespace
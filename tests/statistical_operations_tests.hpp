@@ -78,4 +78,42 @@ TEST_F(MatrixStatOpTest, StDRow) {
     EXPECT_EQ(stdr, test_with);
 }
 
+TEST_F(MatrixStatOpTest, NanReductions) {
+    double nan = std::numeric_limits<double>::quiet_NaN();
+    double inf = std::numeric_limits<double>::infinity();
+    Matrix dirty = matrix.init(std::vector<std::vector<double>>{
+        {1, nan, 3, nan, 5, 6}, {nan, nan, 2, nan, 7, 1}, {4, nan, 8, -inf, 7, 0}});
+    EXPECT_EQ(matrix.nansum(dirty, "column").get(),
+              (std::vector<std::vector<double>>{{5, 0, 13, -inf, 19, 7}}));
+    EXPECT_EQ(matrix.nansum(dirty, "row").get(),
+              (std::vector<std::vector<double>>{{15}, {10}, {-inf}}));
+    EXPECT_EQ(matrix.nanmin(dirty, "column").get_row(0)[2], 2);
+    EXPECT_EQ(matrix.nanmax(dirty, "row").get_col(0), std::vector<double>({6, 7, 8}));
+    EXPECT_EQ(matrix.nanmin(dirty, "row").get_col(0), std::vector<double>({1, 1, -inf}));
+    EXPECT_TRUE(std::isnan(matrix.nanmax(dirty, "column").get_row(0)[1]));
+    EXPECT_EQ(matrix.nanargmax(dirty, "row").get_col(0), std::vector<double>({5, 4, 2}));
+    std::vector<double> argmax = matrix.nanargmax(dirty, "column").get_row(0);
+    EXPECT_EQ(argmax[0], 2);
+    EXPECT_TRUE(std::isnan(argmax[1]));
+    EXPECT_EQ(argmax[3], 2);
+    // The first index of a repeated maximum is kept
+    EXPECT_EQ(argmax[4], 1);
+
+    std::vector<double> mean = matrix.nanmean(dirty, "column").get_row(0);
+    EXPECT_EQ(mean[0], 2.5);
+    EXPECT_TRUE(std::isnan(mean[1]));
+    std::vector<double> stdev = matrix.nanstd(dirty, "column").get_row(0);
+    EXPECT_DOUBLE_EQ(stdev[0], 1.5);
+    EXPECT_DOUBLE_EQ(stdev[2], std::sqrt(62.0 / 9));
+
+    // Without NaN values the results match the plain reductions
+    EXPECT_EQ(matrix.nansum(mat, "row"), matrix.sum(mat, "row"));
+    EXPECT_EQ(matrix.nanmean(mat, "column"), matrix.mean(mat, "column"));
+    EXPECT_EQ(matrix.nanmax(mat, "row"), matrix.max(mat, "row"));
+    EXPECT_EQ(matrix.nanargmax(mat, "column"), matrix.argmax(mat, "column"));
+    std::vector<double> var = matrix.std(mat, "row").get_col(0);
+    for (int i = 0; i < 2; i++)
+        EXPECT_DOUBLE_EQ(matrix.nanstd(mat, "row").get_col(0)[i], std::sqrt(var[i]));
+}
+
 } // namespace
\ No newline at end of file
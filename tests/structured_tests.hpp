@@ -0,0 +1,102 @@
+#include "gtest/gtest.h"
+#include <Matrix.hpp>
+
+namespace {
+
+class StructuredMatrixTest : public ::testing::Test {
+  protected:
+    int n = 90;
+    Matrix dense, B;
+
+    StructuredMatrixTest() {
+        std::vector<std::vector<double>> vec(n, std::vector<double>(n)),
+            rhs(n, std::vector<double>(3));
+        for (int i = 0; i < n; i++) {
+            for (int j = 0; j < n; j++)
+                vec[i][j] = std::sin(i * 0.37 + j * 1.3) + ((i == j) ? n : 0);
+            for (int j = 0; j < 3; j++)
+                rhs[i][j] = std::cos(i * 0.1 + j);
+        }
+        dense = matrix.init(vec);
+        B = matrix.init(rhs);
+    }
+
+    void expect_near(Matrix actual, Matrix expected, double tol) {
+        std::vector<std::vector<double>> a = actual.get(), e = expected.get();
+        ASSERT_EQ(a.size(), e.size());
+        for (size_t i = 0; i < a.size(); i++) {
+            ASSERT_EQ(a[i].size(), e[i].size());
+            for (size_t j = 0; j < a[i].size(); j++)
+                EXPECT_NEAR(a[i][j], e[i][j], tol * (1 + std::abs(e[i][j])));
+        }
+    }
+};
+
+TEST_F(StructuredMatrixTest, Diagonal) {
+    DiagonalMatrix D = matrix.diag(dense);
+    EXPECT_EQ(D.diag.size(), n);
+    EXPECT_EQ(D.get(3, 3), dense.get()[3][3]);
+    EXPECT_EQ(D.get(3, 4), 0);
+    Matrix D_dense = D.to_dense();
+    EXPECT_EQ(matrix.diag(matrix.init(D.diag)).diag, D.diag);
+
+    expect_near(matrix.matmul(D, B), matrix.matmul(D_dense, B), 1e-14);
+    expect_near(matrix.matmul(B.T(), D), matrix.matmul(B.T(), D_dense), 1e-14);
+    expect_near(matrix.solve(D, B), matrix.solve(D_dense, B), 1e-14);
+    expect_near(matrix.inverse(D).to_dense(), matrix.inverse(D_dense), 1e-14);
+    EXPECT_NEAR(matrix.determinant(matrix.diag(matrix.init(std::vector<double>{2, -3, 0.5}))), -3, 1e-15);
+}
+
+TEST_F(StructuredMatrixTest, Triangular) {
+    int threads = matrix.get_num_threads();
+    for (int t : {1, 4}) {
+        matrix.set_num_threads(t);
+        for (bool lower : {true, false}) {
+            TriangularMatrix T = lower ? matrix.tril(dense) : matrix.triu(dense);
+            EXPECT_EQ(T.data.size(), n * (n + 1) / 2);
+            Matrix T_dense = T.to_dense();
+            EXPECT_EQ(T_dense.get()[5][2], lower ? dense.get()[5][2] : 0);
+            EXPECT_EQ(T_dense.get()[2][5], lower ? 0 : dense.get()[2][5]);
+
+            expect_near(matrix.matmul(T, B), matrix.matmul(T_dense, B), 1e-12);
+            expect_near(matrix.solve(T, B), matrix.solve(T_dense, B), 1e-12);
+            TriangularMatrix inv = matrix.inverse(T);
+            EXPECT_EQ(inv.lower, lower);
+            expect_near(inv.to_dense(), matrix.inverse(T_dense), 1e-12);
+
+            double det = 1;
+            for (int i = 0; i < n; i++)
+                det *= T_dense.get()[i][i];
+            EXPECT_EQ(matrix.determinant(T), det);
+        }
+    }
+    matrix.set_num_threads(threads);
+}
+
+TEST_F(StructuredMatrixTest, Symmetric) {
+    // A + A^T is symmetric positive definite since A is diagonally dominant
+    std::vector<std::vector<double>> a = dense.get(), vec = a;
+    for (int i = 0; i < n; i++)
+        for (int j = 0; j < n; j++)
+            vec[i][j] = a[i][j] + a[j][i];
+    Matrix sym = matrix.init(vec);
+    SymmetricMatrix S = matrix.symmetric(sym);
+    EXPECT_EQ(S.data.size(), n * (n + 1) / 2);
+    EXPECT_EQ(S.get(2, 7), S.get(7, 2));
+    EXPECT_EQ(S.to_dense().get(), vec);
+
+    expect_near(matrix.matmul(S, B), matrix.matmul(sym, B), 1e-12);
+    expect_near(matrix.solve(S, B), matrix.solve(sym, B), 1e-10);
+    expect_near(matrix.inverse(S).to_dense(), matrix.inverse(sym), 1e-10);
+    EXPECT_NEAR(matrix.determinant(S) / matrix.lu(sym).determinant(), 1, 1e-10);
+
+    // Indefinite, so the LU fallback is used
+    for (int i = 0; i < n; i++)
+        vec[i][i] = (i % 2 == 0) ? -vec[i][i] : vec[i][i];
+    Matrix indefinite = matrix.init(vec);
+    SymmetricMatrix S2 = matrix.symmetric(indefinite);
+    expect_near(matrix.solve(S2, B), matrix.solve(indefinite, B), 1e-10);
+    EXPECT_NEAR(matrix.determinant(S2) / matrix.lu(indefinite).determinant(), 1, 1e-10);
+}
+
+} // namespace
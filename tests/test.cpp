@@ -1,12 +1,17 @@
 #include "algebra_tests.hpp"
 #include "basic_operations_tests.hpp"
+#include "batch_tests.hpp"
+#include "csv_tests.hpp"
 #include "initialization_tests.hpp"
+#include "io_tests.hpp"
 #include "logical_operations_tests.hpp"
 #include "mathematical_operations_tests.hpp"
 #include "min_max_tests.hpp"
 #include "miscellaneous_tests.hpp"
 #include "slicing_tests.hpp"
+#include "sparse_tests.hpp"
 #include "statistical_operations_tests.hpp"
+#include "structured_tests.hpp"
 
 int main(int argc, char **argv) {
     ::testing::InitGoogleTest(&argc, argv);